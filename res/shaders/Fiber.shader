@@ -0,0 +1,44 @@
+#shader vertex
+#version 410 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec4 fiberColor; //RGBA8, normalized
+
+uniform mat4 u_MVP;
+// Snorm16 sets and sets uploaded from a stored file: position is relative to the fiber's bounds
+// (unit bounds for float files), and the color is per fiber. u_FiberData holds center, half extent
+// and color for each fiber; fibers are u_SamplesPerFiber long
+uniform int u_Quantized;
+uniform int u_SamplesPerFiber;
+uniform samplerBuffer u_FiberData;
+
+out vec4 fragmentColor;
+
+void main()
+{
+    if (u_Quantized != 0)
+    {
+        int fiber = gl_VertexID / u_SamplesPerFiber;
+        vec3 center = texelFetch(u_FiberData, fiber * 3).xyz;
+        vec3 halfExtent = texelFetch(u_FiberData, fiber * 3 + 1).xyz;
+        gl_Position = u_MVP * vec4(center + halfExtent * position.xyz, 1.0);
+        fragmentColor = texelFetch(u_FiberData, fiber * 3 + 2);
+    }
+    else
+    {
+        gl_Position = u_MVP * position;
+        fragmentColor = fiberColor;
+    }
+}
+
+#shader fragment
+#version 410 core
+
+in vec4 fragmentColor;
+
+out vec4 color;
+
+void main()
+{
+    color = fragmentColor;
+}
\ No newline at end of file
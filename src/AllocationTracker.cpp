@@ -0,0 +1,238 @@
+#include "AllocationTracker.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+// Nothing in here may allocate from the heap: it runs inside operator new.
+namespace
+{
+    std::atomic<unsigned long long> g_Allocations(0);
+    std::atomic<unsigned long long> g_Bytes(0);
+    std::atomic<unsigned long long> g_LiveBytes(0);
+    std::atomic<unsigned long long> g_PeakLiveBytes(0);
+
+    thread_local unsigned long long t_Allocations = 0;
+    thread_local unsigned long long t_Bytes = 0;
+
+    AllocationStats g_FrameStart;
+    AllocationStats g_LastFrame;
+    AllocationStats g_MaxFrame;
+
+    const int g_MaxScopes = 64;
+    std::mutex g_ScopeMutex;
+    AllocationScopeStats g_Scopes[g_MaxScopes];
+    int g_NumScopes = 0;
+
+#ifdef HOPF_TRACK_ALLOCATIONS
+    // Every block carries its size in front so delete can account for it; 16 bytes keeps the
+    // alignment malloc guarantees
+    const size_t g_HeaderSize = 16;
+
+    void* TrackedAllocate(size_t size)
+    {
+        unsigned char* block = (unsigned char*)malloc(size + g_HeaderSize);
+        if (!block)
+            return nullptr;
+        memcpy(block, &size, sizeof(size));
+
+        g_Allocations.fetch_add(1, std::memory_order_relaxed);
+        g_Bytes.fetch_add(size, std::memory_order_relaxed);
+        unsigned long long live = g_LiveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        unsigned long long peak = g_PeakLiveBytes.load(std::memory_order_relaxed);
+        while (live > peak && !g_PeakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        {
+        }
+        t_Allocations++;
+        t_Bytes += size;
+        return block + g_HeaderSize;
+    }
+
+    void TrackedFree(void* pointer)
+    {
+        if (!pointer)
+            return;
+        unsigned char* block = (unsigned char*)pointer - g_HeaderSize;
+        size_t size;
+        memcpy(&size, block, sizeof(size));
+        g_LiveBytes.fetch_sub(size, std::memory_order_relaxed);
+        free(block);
+    }
+#endif
+}
+
+#ifdef HOPF_TRACK_ALLOCATIONS
+void* operator new(size_t size)
+{
+    void* pointer = TrackedAllocate(size);
+    if (!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](size_t size)
+{
+    void* pointer = TrackedAllocate(size);
+    if (!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return TrackedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return TrackedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    TrackedFree(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    TrackedFree(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    TrackedFree(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    TrackedFree(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    TrackedFree(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    TrackedFree(pointer);
+}
+#endif
+
+bool AllocationTracker::IsAvailable()
+{
+#ifdef HOPF_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AllocationTracker::BeginFrame()
+{
+    AllocationStats now = GetTotal();
+    g_LastFrame.allocations = now.allocations - g_FrameStart.allocations;
+    g_LastFrame.bytes = now.bytes - g_FrameStart.bytes;
+    if (g_LastFrame.allocations > g_MaxFrame.allocations)
+        g_MaxFrame.allocations = g_LastFrame.allocations;
+    if (g_LastFrame.bytes > g_MaxFrame.bytes)
+        g_MaxFrame.bytes = g_LastFrame.bytes;
+    g_FrameStart = now;
+}
+
+AllocationStats AllocationTracker::GetLastFrame()
+{
+    return g_LastFrame;
+}
+
+AllocationStats AllocationTracker::GetMaxFrame()
+{
+    return g_MaxFrame;
+}
+
+void AllocationTracker::ResetHighWater()
+{
+    g_MaxFrame = AllocationStats();
+    g_PeakLiveBytes.store(g_LiveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+AllocationStats AllocationTracker::GetTotal()
+{
+    AllocationStats stats;
+    stats.allocations = g_Allocations.load(std::memory_order_relaxed);
+    stats.bytes = g_Bytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+unsigned long long AllocationTracker::GetLiveBytes()
+{
+    return g_LiveBytes.load(std::memory_order_relaxed);
+}
+
+unsigned long long AllocationTracker::GetPeakLiveBytes()
+{
+    return g_PeakLiveBytes.load(std::memory_order_relaxed);
+}
+
+AllocationStats AllocationTracker::GetThreadTotal()
+{
+    AllocationStats stats;
+    stats.allocations = t_Allocations;
+    stats.bytes = t_Bytes;
+    return stats;
+}
+
+void AllocationTracker::AddScope(const char* name, const AllocationStats& delta)
+{
+    std::lock_guard<std::mutex> lock(g_ScopeMutex);
+    int index = 0;
+    while (index < g_NumScopes && strcmp(g_Scopes[index].name, name) != 0)
+        index++;
+    if (index == g_NumScopes)
+    {
+        if (g_NumScopes == g_MaxScopes)
+            return;
+        g_Scopes[index] = AllocationScopeStats();
+        g_Scopes[index].name = name;
+        g_NumScopes++;
+    }
+    AllocationScopeStats& scope = g_Scopes[index];
+    scope.calls++;
+    scope.total.allocations += delta.allocations;
+    scope.total.bytes += delta.bytes;
+    if (delta.allocations > scope.maxPerCall.allocations)
+        scope.maxPerCall.allocations = delta.allocations;
+    if (delta.bytes > scope.maxPerCall.bytes)
+        scope.maxPerCall.bytes = delta.bytes;
+}
+
+int AllocationTracker::GetScopes(AllocationScopeStats* scopes, int maxScopes)
+{
+    std::lock_guard<std::mutex> lock(g_ScopeMutex);
+    int count = g_NumScopes < maxScopes ? g_NumScopes : maxScopes;
+    for (int i = 0; i < count; i++)
+        scopes[i] = g_Scopes[i];
+    return count;
+}
+
+void AllocationTracker::ResetScopes()
+{
+    std::lock_guard<std::mutex> lock(g_ScopeMutex);
+    g_NumScopes = 0;
+}
+
+AllocationScope::AllocationScope(const char* name)
+    : m_Name(name), m_Start(AllocationTracker::GetThreadTotal())
+{
+}
+
+AllocationScope::~AllocationScope()
+{
+    AllocationStats now = AllocationTracker::GetThreadTotal();
+    AllocationStats delta;
+    delta.allocations = now.allocations - m_Start.allocations;
+    delta.bytes = now.bytes - m_Start.bytes;
+    AllocationTracker::AddScope(m_Name, delta);
+}
\ No newline at end of file
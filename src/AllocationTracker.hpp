@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+
+// Opt-in heap accounting. Building with HOPF_TRACK_ALLOCATIONS (CMake option of the same name) replaces the
+// global operator new/delete with versions that count allocations and bytes; without it every query
+// returns zeros and IsAvailable() is false.
+//
+// Counts are kept globally (per frame, with high-water marks) and per named scope:
+//
+//     void Hopf::UpdateCircles(...)
+//     {
+//         ALLOC_SCOPE("Hopf::UpdateCircles");
+//         ...
+//     }
+//
+// Scope counts only include allocations made on the thread that opened the scope.
+
+struct AllocationStats
+{
+    unsigned long long allocations = 0;
+    unsigned long long bytes = 0;
+};
+
+struct AllocationScopeStats
+{
+    const char* name = nullptr;
+    unsigned long long calls = 0;
+    AllocationStats total;
+    AllocationStats maxPerCall;
+};
+
+class AllocationTracker
+{
+public:
+    static bool IsAvailable();
+
+    // Closes the running frame; its counts become GetLastFrame() and feed the high-water marks
+    static void BeginFrame();
+    static AllocationStats GetLastFrame();
+    static AllocationStats GetMaxFrame();       //worst frame since the last ResetHighWater
+    static void ResetHighWater();
+
+    static AllocationStats GetTotal();          //since program start
+    static unsigned long long GetLiveBytes();
+    static unsigned long long GetPeakLiveBytes();
+
+    // Copies up to maxScopes scope records into scopes and returns how many were written
+    static int GetScopes(AllocationScopeStats* scopes, int maxScopes);
+    static void ResetScopes();
+
+    static AllocationStats GetThreadTotal();    //allocations made by the calling thread
+    static void AddScope(const char* name, const AllocationStats& delta);
+};
+
+class AllocationScope
+{
+public:
+    explicit AllocationScope(const char* name);
+    ~AllocationScope();
+
+private:
+    AllocationScope(const AllocationScope&);
+    AllocationScope& operator=(const AllocationScope&);
+
+    const char* m_Name;
+    AllocationStats m_Start;
+};
+
+#ifdef HOPF_TRACK_ALLOCATIONS
+#define ALLOC_SCOPE_CONCAT_INNER(a, b) a##b
+#define ALLOC_SCOPE_CONCAT(a, b) ALLOC_SCOPE_CONCAT_INNER(a, b)
+#define ALLOC_SCOPE(name) AllocationScope ALLOC_SCOPE_CONCAT(allocationScope, __LINE__)(name)
+#else
+#define ALLOC_SCOPE(name) ((void)0)
+#endif
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "AsyncReadback.hpp"
+
+#include <cstring>
+#include <utility>
+
+AsyncReadback::AsyncReadback(int maxWidth, int maxHeight, int ringSize)
+    : m_SlotSize((size_t)maxWidth * maxHeight * 4), m_Head(0), m_Tail(0), m_InFlight(0)
+{
+    m_Slots.resize(ringSize);
+    for (int i = 0; i < ringSize; i++)
+    {
+        Slot& slot = m_Slots[i];
+        slot.fence = 0;
+        slot.width = 0;
+        slot.height = 0;
+        slot.tag = 0;
+        GLCall(glGenBuffers(1, &slot.buffer));
+        GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer));
+        GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, m_SlotSize, nullptr, GL_STREAM_READ));
+    }
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+}
+
+AsyncReadback::~AsyncReadback()
+{
+    Delete();
+}
+
+AsyncReadback::AsyncReadback(AsyncReadback&& other) noexcept
+    : m_Slots(std::move(other.m_Slots)), m_SlotSize(other.m_SlotSize), m_Head(other.m_Head), m_Tail(other.m_Tail), m_InFlight(other.m_InFlight)
+{
+    other.m_Slots.clear();
+    other.m_InFlight = 0;
+}
+
+AsyncReadback& AsyncReadback::operator=(AsyncReadback&& other) noexcept
+{
+    if (this != &other)
+    {
+        Delete();
+        m_Slots = std::move(other.m_Slots);
+        m_SlotSize = other.m_SlotSize;
+        m_Head = other.m_Head;
+        m_Tail = other.m_Tail;
+        m_InFlight = other.m_InFlight;
+        other.m_Slots.clear();
+        other.m_InFlight = 0;
+    }
+    return *this;
+}
+
+bool AsyncReadback::Request(int x, int y, int width, int height, long long tag)
+{
+    if (m_InFlight == (int)m_Slots.size() || (size_t)width * height * 4 > m_SlotSize)
+    {
+        return false;
+    }
+    Slot& slot = m_Slots[m_Head];
+    slot.width = width;
+    slot.height = height;
+    slot.tag = tag;
+
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer));
+    GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 4));
+    GLCall(glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr)); //into the PBO, returns without waiting
+    GLCall(slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    m_Head = (m_Head + 1) % m_Slots.size();
+    m_InFlight++;
+    return true;
+}
+
+bool AsyncReadback::Retrieve(std::vector<unsigned char>& pixels, int& width, int& height, long long& tag, bool wait)
+{
+    if (m_InFlight == 0)
+    {
+        return false;
+    }
+    Slot& slot = m_Slots[m_Tail];
+    GLuint64 timeout = wait ? 1000000000ull : 0; //1s per attempt while waiting
+    GLenum status;
+    do
+    {
+        GLCall(status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeout));
+    } while (wait && status == GL_TIMEOUT_EXPIRED);
+    if (status == GL_TIMEOUT_EXPIRED)
+    {
+        return false;
+    }
+    GLCall(glDeleteSync(slot.fence));
+    slot.fence = 0;
+
+    size_t size = (size_t)slot.width * slot.height * 4;
+    pixels.resize(size);
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer));
+    GLCall(const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT));
+    if (mapped)
+    {
+        memcpy(&pixels[0], mapped, size);
+    }
+    GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    width = slot.width;
+    height = slot.height;
+    tag = slot.tag;
+    m_Tail = (m_Tail + 1) % m_Slots.size();
+    m_InFlight--;
+    return mapped != nullptr;
+}
+
+void AsyncReadback::Delete()
+{
+    for (size_t i = 0; i < m_Slots.size(); i++)
+    {
+        if (m_Slots[i].fence)
+        {
+            GLCall(glDeleteSync(m_Slots[i].fence));
+        }
+        GLCall(glDeleteBuffers(1, &m_Slots[i].buffer));
+    }
+    m_Slots.clear();
+    m_Head = 0;
+    m_Tail = 0;
+    m_InFlight = 0;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+
+#include "Renderer.hpp"
+
+// Reads pixels from the bound read framebuffer through a ring of pixel buffer objects.
+// glReadPixels into a PBO returns immediately; the data is mapped a few frames later once its fence
+// has signalled, so the CPU never waits for the GPU to drain the pipeline.
+// Owns its buffers and fences: move-only, released in the destructor
+class AsyncReadback
+{
+public:
+    AsyncReadback(int maxWidth, int maxHeight, int ringSize);
+    ~AsyncReadback();
+    AsyncReadback(AsyncReadback&& other) noexcept;
+    AsyncReadback& operator=(AsyncReadback&& other) noexcept;
+    AsyncReadback(const AsyncReadback&) = delete;
+    AsyncReadback& operator=(const AsyncReadback&) = delete;
+
+    // Starts an RGBA8 read of the given rectangle. Returns false when every slot is still in flight.
+    bool Request(int x, int y, int width, int height, long long tag);
+    // Copies out the oldest read. Without wait it returns false if the GPU has not finished it yet.
+    bool Retrieve(std::vector<unsigned char>& pixels, int& width, int& height, long long& tag, bool wait);
+    void Delete(); //releases the ring early; safe to call more than once
+
+    inline int GetInFlight() const { return m_InFlight; }
+    inline int GetRingSize() const { return (int)m_Slots.size(); }
+
+private:
+    struct Slot
+    {
+        unsigned int buffer;
+        GLsync fence;
+        int width;
+        int height;
+        long long tag;
+    };
+
+    std::vector<Slot> m_Slots;
+    size_t m_SlotSize;
+    int m_Head;
+    int m_Tail;
+    int m_InFlight;
+};
\ No newline at end of file
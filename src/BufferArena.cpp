@@ -0,0 +1,181 @@
+#include "BufferArena.hpp"
+#include "Renderer.hpp"
+#include "GLStats.hpp"
+#include <iostream>
+
+BufferArena& BufferArena::Get()
+{
+    static BufferArena arena;
+    return arena;
+}
+
+BufferArena::~BufferArena()
+{
+    // Blocks are released as they empty, while the context is still current. Anything left here
+    // belongs to a context that is already gone, so it is not touched.
+    for (size_t i = 0; i < m_Blocks.size(); i++)
+    {
+        if (m_Blocks[i].buffer)
+            std::cout << "[BufferArena] " << m_Blocks[i].allocations << " ranges still allocated at exit" << std::endl;
+    }
+}
+
+static unsigned int AlignUp(unsigned int size)
+{
+    return (size + BufferArena::Alignment - 1) / BufferArena::Alignment * BufferArena::Alignment;
+}
+
+int BufferArena::CreateBlock(unsigned int size)
+{
+    int slot = -1;
+    for (size_t i = 0; i < m_Blocks.size() && slot < 0; i++)
+    {
+        if (!m_Blocks[i].buffer)
+            slot = (int)i;
+    }
+    if (slot < 0)
+    {
+        slot = (int)m_Blocks.size();
+        m_Blocks.push_back(Block());
+    }
+    Block& block = m_Blocks[slot];
+    GLCall(glGenBuffers(1, &block.buffer));
+    GLCall(glBindBuffer(GL_ARRAY_BUFFER, block.buffer));
+    GLCall(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+    block.size = size;
+    block.used = 0;
+    block.allocations = 0;
+    block.freeRanges.clear();
+    block.freeRanges[0] = size;
+    return slot;
+}
+
+void BufferArena::ReleaseBlock(int index)
+{
+    Block& block = m_Blocks[index];
+    GLCall(glDeleteBuffers(1, &block.buffer));
+    block = Block();
+}
+
+BufferRange BufferArena::Allocate(unsigned int size)
+{
+    BufferRange range;
+    if (size == 0)
+        return range;
+    size = AlignUp(size);
+
+    // Best fit over every block's free list
+    int bestBlock = -1;
+    unsigned int bestOffset = 0;
+    unsigned int bestSize = 0;
+    for (size_t i = 0; i < m_Blocks.size(); i++)
+    {
+        const Block& block = m_Blocks[i];
+        if (!block.buffer || block.size - block.used < size)
+            continue;
+        for (std::map<unsigned int, unsigned int>::const_iterator it = block.freeRanges.begin(); it != block.freeRanges.end(); ++it)
+        {
+            if (it->second >= size && (bestBlock < 0 || it->second < bestSize))
+            {
+                bestBlock = (int)i;
+                bestOffset = it->first;
+                bestSize = it->second;
+            }
+        }
+    }
+    if (bestBlock < 0)
+    {
+        bestBlock = CreateBlock(size > BlockSize ? size : BlockSize);
+        bestOffset = 0;
+        bestSize = m_Blocks[bestBlock].size;
+    }
+
+    Block& block = m_Blocks[bestBlock];
+    block.freeRanges.erase(bestOffset);
+    if (bestSize > size)
+        block.freeRanges[bestOffset + size] = bestSize - size;
+    block.used += size;
+    block.allocations++;
+    m_TotalAllocations++;
+
+    range.buffer = block.buffer;
+    range.offset = bestOffset;
+    range.size = size;
+    range.block = bestBlock;
+    return range;
+}
+
+void BufferArena::Free(BufferRange& range)
+{
+    if (range.block < 0)
+        return;
+    Block& block = m_Blocks[range.block];
+    unsigned int offset = range.offset;
+    unsigned int size = range.size;
+
+    // Merge with the free ranges on either side
+    std::map<unsigned int, unsigned int>::iterator next = block.freeRanges.lower_bound(offset);
+    if (next != block.freeRanges.end() && offset + size == next->first)
+    {
+        size += next->second;
+        next = block.freeRanges.erase(next);
+    }
+    if (next != block.freeRanges.begin())
+    {
+        std::map<unsigned int, unsigned int>::iterator prev = next;
+        --prev;
+        if (prev->first + prev->second == offset)
+        {
+            offset = prev->first;
+            size += prev->second;
+            block.freeRanges.erase(prev);
+        }
+    }
+    block.freeRanges[offset] = size;
+    block.used -= range.size;
+    block.allocations--;
+    m_TotalFrees++;
+
+    if (block.allocations == 0)
+        ReleaseBlock(range.block);
+    range = BufferRange();
+}
+
+void BufferArena::Upload(const BufferRange& range, const void* data, unsigned int size)
+{
+    if (range.block < 0 || size == 0)
+        return;
+    if (size > range.size)
+    {
+        std::cout << "[BufferArena] upload of " << size << " bytes into a range of " << range.size << std::endl;
+        return;
+    }
+    GLStats::CountBufferBind();
+    GLCall(glBindBuffer(GL_ARRAY_BUFFER, range.buffer));
+    GLCall(glBufferSubData(GL_ARRAY_BUFFER, range.offset, size, data));
+    GLStats::CountUpload(size);
+}
+
+BufferArenaStats BufferArena::GetStats() const
+{
+    BufferArenaStats stats;
+    for (size_t i = 0; i < m_Blocks.size(); i++)
+    {
+        const Block& block = m_Blocks[i];
+        if (!block.buffer)
+            continue;
+        stats.blocks++;
+        stats.capacity += block.size;
+        stats.used += block.used;
+        stats.allocations += block.allocations;
+        stats.freeRanges += (unsigned int)block.freeRanges.size();
+        for (std::map<unsigned int, unsigned int>::const_iterator it = block.freeRanges.begin(); it != block.freeRanges.end(); ++it)
+        {
+            if (it->second > stats.largestFree)
+                stats.largestFree = it->second;
+        }
+    }
+    stats.totalAllocations = m_TotalAllocations;
+    stats.totalFrees = m_TotalFrees;
+    return stats;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <map>
+#include <vector>
+
+// A byte range handed out by a BufferArena: buffer is the GL name of the block it lives in
+struct BufferRange
+{
+    unsigned int buffer = 0;
+    unsigned int offset = 0;    //bytes from the start of the block, a multiple of BufferArena::Alignment
+    unsigned int size = 0;      //bytes reserved, rounded up to the alignment
+    int block = -1;             //-1 when the range is empty
+};
+
+struct BufferArenaStats
+{
+    unsigned int blocks = 0;
+    unsigned long long capacity = 0;        //bytes in all blocks
+    unsigned long long used = 0;            //bytes in live ranges
+    unsigned int allocations = 0;           //live ranges
+    unsigned int freeRanges = 0;
+    unsigned long long largestFree = 0;
+    unsigned long long totalAllocations = 0;
+    unsigned long long totalFrees = 0;
+};
+
+// Sub-allocates the small vertex and index buffers of the scene geometry out of a few large GL buffers.
+// Each block keeps a free list ordered by offset; Allocate takes the best fit over all blocks, Free
+// coalesces with the neighbouring free ranges, and a block is released as soon as it is empty, so
+// regenerating an object reuses its old space instead of fragmenting the blocks. All GL work happens
+// on one thread, so there is no locking.
+class BufferArena
+{
+public:
+    static const unsigned int BlockSize = 4 << 20;
+    static const unsigned int Alignment = 16;   //covers every vertex attribute and index type we use
+
+    static BufferArena& Get(); //the arena shared by render_geom
+
+    BufferArena() {};
+    ~BufferArena();
+    BufferArena(const BufferArena&) = delete;
+    BufferArena& operator=(const BufferArena&) = delete;
+
+    // Reserves size bytes; larger than BlockSize gets a block of its own
+    BufferRange Allocate(unsigned int size);
+    // Returns the range to its block and clears it; empty ranges are ignored
+    void Free(BufferRange& range);
+    // glBufferSubData into the range, size <= range.size
+    void Upload(const BufferRange& range, const void* data, unsigned int size);
+
+    BufferArenaStats GetStats() const;
+
+private:
+    struct Block
+    {
+        unsigned int buffer = 0;    //0 for a released slot
+        unsigned int size = 0;
+        unsigned int used = 0;
+        unsigned int allocations = 0;
+        std::map<unsigned int, unsigned int> freeRanges; //offset -> size
+    };
+
+    int CreateBlock(unsigned int size);
+    void ReleaseBlock(int block);
+
+    std::vector<Block> m_Blocks;
+    unsigned long long m_TotalAllocations = 0;
+    unsigned long long m_TotalFrees = 0;
+};
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "BufferTexture.hpp"
+#include "Profiler.hpp"
+#include "GLStats.hpp"
+
+BufferTexture::BufferTexture(const void* data, unsigned int size, unsigned int internalFormat)
+    : m_InternalFormat(internalFormat), m_Size(size)
+{
+    PROFILE_SCOPE("BufferTexture upload");
+    GLCall(glGenBuffers(1, &m_BufferID));
+    GLCall(glBindBuffer(GL_TEXTURE_BUFFER, m_BufferID));
+    GLCall(glBufferData(GL_TEXTURE_BUFFER, size, data, GL_STATIC_DRAW));
+    GLCall(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+    GLStats::CountUpload(size);
+
+    GLCall(glGenTextures(1, &m_TextureID));
+    GLCall(glBindTexture(GL_TEXTURE_BUFFER, m_TextureID));
+    GLCall(glTexBuffer(GL_TEXTURE_BUFFER, m_InternalFormat, m_BufferID)); //the texture is a view of the buffer
+    GLCall(glBindTexture(GL_TEXTURE_BUFFER, 0));
+}
+
+void BufferTexture::UpdateData(const void* data, unsigned int size)
+{
+    PROFILE_SCOPE("BufferTexture::UpdateData");
+    GLCall(glBindBuffer(GL_TEXTURE_BUFFER, m_BufferID));
+    if (size <= m_Size)
+    {
+        GLCall(glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data));
+    }
+    else
+    {
+        GLCall(glBufferData(GL_TEXTURE_BUFFER, size, data, GL_DYNAMIC_DRAW));
+        m_Size = size;
+    }
+    GLCall(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+    GLStats::CountUpload(size);
+}
+
+BufferTexture::~BufferTexture()
+{
+    Delete();
+}
+
+BufferTexture::BufferTexture(BufferTexture&& other) noexcept
+    : m_BufferID(other.m_BufferID), m_TextureID(other.m_TextureID), m_InternalFormat(other.m_InternalFormat), m_Size(other.m_Size)
+{
+    other.m_BufferID = 0;
+    other.m_TextureID = 0;
+    other.m_Size = 0;
+}
+
+BufferTexture& BufferTexture::operator=(BufferTexture&& other) noexcept
+{
+    if (this != &other)
+    {
+        Delete();
+        m_BufferID = other.m_BufferID;
+        m_TextureID = other.m_TextureID;
+        m_InternalFormat = other.m_InternalFormat;
+        m_Size = other.m_Size;
+        other.m_BufferID = 0;
+        other.m_TextureID = 0;
+        other.m_Size = 0;
+    }
+    return *this;
+}
+
+void BufferTexture::Delete()
+{
+    if (m_TextureID)
+    {
+        GLCall(glDeleteTextures(1, &m_TextureID));
+        m_TextureID = 0;
+    }
+    if (m_BufferID)
+    {
+        GLCall(glDeleteBuffers(1, &m_BufferID));
+        m_BufferID = 0;
+    }
+    m_Size = 0;
+}
+
+void BufferTexture::Bind(unsigned int slot) const
+{
+    GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+    GLCall(glBindTexture(GL_TEXTURE_BUFFER, m_TextureID));
+}
+
+void BufferTexture::Unbind() const
+{
+    GLCall(glBindTexture(GL_TEXTURE_BUFFER, 0));
+}
\ No newline at end of file
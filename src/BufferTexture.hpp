@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Renderer.hpp"
+
+// A buffer read by shaders through a samplerBuffer (texelFetch), for per-fiber data that one
+// multi-draw cannot pass as uniforms. Owns the buffer and the texture: move-only, released in the destructor
+class BufferTexture
+{
+public:
+	BufferTexture() {};
+	BufferTexture(const void* data, unsigned int size, unsigned int internalFormat); //e.g. GL_RGBA32F
+	~BufferTexture();
+	BufferTexture(BufferTexture&& other) noexcept;
+	BufferTexture& operator=(BufferTexture&& other) noexcept;
+	BufferTexture(const BufferTexture&) = delete;
+	BufferTexture& operator=(const BufferTexture&) = delete;
+
+	void UpdateData(const void* data, unsigned int size);
+	void Bind(unsigned int slot = 0) const;
+	void Unbind() const;
+	void Delete(); //safe to call more than once
+
+	inline bool IsValid() const { return m_TextureID != 0; }
+private:
+	unsigned int m_BufferID = 0;
+	unsigned int m_TextureID = 0;
+	unsigned int m_InternalFormat = 0;
+	unsigned int m_Size = 0;
+};
\ No newline at end of file
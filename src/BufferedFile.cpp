@@ -0,0 +1,128 @@
+#include "BufferedFile.hpp"
+
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+BufferedFile::BufferedFile()
+    :
+#ifdef _WIN32
+      m_File(INVALID_HANDLE_VALUE),
+#else
+      m_File(-1),
+#endif
+      m_Open(false), m_Failed(false)
+{
+}
+
+BufferedFile::~BufferedFile()
+{
+    Close();
+}
+
+bool BufferedFile::Open(const std::string& path)
+{
+    Close();
+#ifdef _WIN32
+    m_File = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    m_Open = m_File != INVALID_HANDLE_VALUE;
+#else
+    m_File = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    m_Open = m_File >= 0;
+#endif
+    m_Failed = !m_Open;
+    if (!m_Open)
+    {
+        std::cout << "BufferedFile: could not open " << path << std::endl;
+    }
+    return m_Open;
+}
+
+bool BufferedFile::WriteAt(uint64_t offset, const void* data, size_t size)
+{
+    if (!m_Open)
+    {
+        return false;
+    }
+    const char* bytes = (const char*)data;
+    while (size > 0 && !m_Failed)
+    {
+#ifdef _WIN32
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+        overlapped.OffsetHigh = (DWORD)(offset >> 32);
+        DWORD chunk = size > (1u << 30) ? (1u << 30) : (DWORD)size;
+        DWORD written = 0;
+        if (!WriteFile(m_File, bytes, chunk, &written, &overlapped) || written == 0)
+        {
+            m_Failed = true;
+            break;
+        }
+#else
+        ssize_t written = pwrite(m_File, bytes, size, (off_t)offset);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            m_Failed = true;
+            break;
+        }
+#endif
+        bytes += written;
+        offset += written;
+        size -= written;
+    }
+    return !m_Failed;
+}
+
+bool BufferedFile::Close()
+{
+    if (!m_Open)
+    {
+        return !m_Failed;
+    }
+#ifdef _WIN32
+    CloseHandle(m_File);
+    m_File = INVALID_HANDLE_VALUE;
+#else
+    if (close(m_File) != 0)
+    {
+        m_Failed = true;
+    }
+    m_File = -1;
+#endif
+    m_Open = false;
+    return !m_Failed;
+}
+
+RegionWriter::RegionWriter(BufferedFile& file, uint64_t offset, size_t bufferSize)
+    : m_File(file), m_Offset(offset), m_Capacity(bufferSize)
+{
+    m_Buffer.reserve(bufferSize);
+}
+
+RegionWriter::~RegionWriter()
+{
+    Flush();
+}
+
+void RegionWriter::Flush()
+{
+    if (m_Buffer.empty())
+    {
+        return;
+    }
+    m_File.WriteAt(m_Offset, &m_Buffer[0], m_Buffer.size());
+    m_Offset += m_Buffer.size();
+    m_Buffer.clear();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Output file that can be written at arbitrary offsets (pwrite on POSIX), so several sections of one
+// file can be streamed at the same time without seeking back and forth.
+class BufferedFile
+{
+public:
+    BufferedFile();
+    ~BufferedFile();
+
+    bool Open(const std::string& path);
+    bool WriteAt(uint64_t offset, const void* data, size_t size);
+    bool Close();
+
+    inline bool IsOpen() const { return m_Open; }
+    inline bool HasFailed() const { return m_Failed; }
+
+private:
+#ifdef _WIN32
+    void* m_File;
+#else
+    int m_File;
+#endif
+    bool m_Open;
+    bool m_Failed;
+};
+
+// Appends to one section of a BufferedFile through a large buffer, issuing one positional write per flush
+class RegionWriter
+{
+public:
+    RegionWriter(BufferedFile& file, uint64_t offset, size_t bufferSize = 4 << 20);
+    ~RegionWriter();
+
+    inline void Write(const void* data, size_t size)
+    {
+        if (m_Buffer.size() + size > m_Capacity)
+        {
+            Flush();
+            if (size >= m_Capacity)
+            {
+                m_File.WriteAt(m_Offset, data, size);
+                m_Offset += size;
+                return;
+            }
+        }
+        const unsigned char* bytes = (const unsigned char*)data;
+        m_Buffer.insert(m_Buffer.end(), bytes, bytes + size);
+    }
+    void Flush();
+
+    inline uint64_t GetPosition() const { return m_Offset + m_Buffer.size(); }
+
+private:
+    BufferedFile& m_File;
+    uint64_t m_Offset;
+    size_t m_Capacity;
+    std::vector<unsigned char> m_Buffer;
+};
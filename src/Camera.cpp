@@ -19,6 +19,13 @@ void Camera::SetFOV(float fov)
 	RecalculateProjectionMatrix();
 }
 
+void Camera::SetOrientation(float yaw, float pitch)
+{
+	m_Yaw = yaw;
+	m_Pitch = pitch;
+	UpdateCameraVectors();
+}
+
 void Camera::SetPosition(const glm::vec3& position) {
 	m_Position = position;
 	RecalculateViewMatrix();
@@ -43,6 +50,18 @@ const glm::mat4& Camera::GetProjectionMatrix() const
 	return m_ProjectionMatrix;
 }
 
+glm::mat4 Camera::GetTileProjectionMatrix(float x0, float y0, float x1, float y1) const
+{
+	// Same frustum as glm::perspective, sliced at the near plane
+	float top = m_Near * tan(glm::radians(m_FOV) / 2.0f);
+	float right = top * m_AspectRatio;
+	float left = -right + 2.0f * right * x0;
+	float tileRight = -right + 2.0f * right * x1;
+	float bottom = -top + 2.0f * top * y0;
+	float tileTop = -top + 2.0f * top * y1;
+	return glm::frustum(left, tileRight, bottom, tileTop, m_Near, m_Far);
+}
+
 void Camera::ProcessControls()
 {
 	if (m_Controls->KeyLogic(GLFW_KEY_W))
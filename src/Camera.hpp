@@ -12,14 +12,20 @@ public:
     void BindControls(Controls* controls);
     const glm::mat4& GetViewMatrix() const;
     const glm::mat4& GetProjectionMatrix() const;
+    // Off-center projection covering the sub-rectangle [x0, x1] x [y0, y1] of the view, in 0..1 window coordinates
+    glm::mat4 GetTileProjectionMatrix(float x0, float y0, float x1, float y1) const;
     void ProcessControls();
     glm::vec3 getPosition() { return m_Position; }
     glm::vec3 getFront() { return m_Front; }
     glm::vec3 getUp() { return m_Up; }
+    float getYaw() const { return m_Yaw; }
+    float getPitch() const { return m_Pitch; }
+    float getFOV() const { return m_FOV; }
 
     void SetPosition(const glm::vec3& position);
     void SetFront(const glm::vec3& front);
     void SetFOV(float fov);
+    void SetOrientation(float yaw, float pitch); //degrees, as accumulated by ProcessMouseMovement
     void setSpeed(float speed) { m_Speed = speed; }
     void setSensitivity(float sensitivity) { m_MouseSensitivity = sensitivity; }
     void setMouseEnabled() { m_MouseEnabled = true; }
@@ -0,0 +1,118 @@
+#include "CameraPath.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+const double CameraPath::TimeStep = 1.0 / 60.0;
+
+void CameraPath::Clear()
+{
+    m_Frames.clear();
+    m_Changes.clear();
+    m_Current.clear();
+}
+
+void CameraPath::AddFrame(const CameraPathFrame& frame, const CameraPathParams& params)
+{
+    int index = (int)m_Frames.size();
+    for (CameraPathParams::const_iterator it = params.begin(); it != params.end(); ++it)
+    {
+        CameraPathParams::iterator current = m_Current.find(it->first);
+        if (current == m_Current.end() || current->second != it->second)
+        {
+            ParamChange change = { index, it->first, it->second };
+            m_Changes.push_back(change);
+            m_Current[it->first] = it->second;
+        }
+    }
+    m_Frames.push_back(frame);
+}
+
+bool CameraPath::Save(const std::string& path) const
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file)
+    {
+        std::cout << "Could not open " << path << std::endl;
+        return false;
+    }
+    fprintf(file, "# hopf camera path, %d frames at %.6f s\n", GetNumFrames(), TimeStep);
+    size_t change = 0;
+    for (int i = 0; i < GetNumFrames(); i++)
+    {
+        for (; change < m_Changes.size() && m_Changes[change].frame == i; change++)
+        {
+            fprintf(file, "param %s %.9g\n", m_Changes[change].name.c_str(), m_Changes[change].value);
+        }
+        const CameraPathFrame& frame = m_Frames[i];
+        // %.9g round-trips a float exactly, so a replay sees the recorded matrices bit for bit
+        fprintf(file, "frame %.9g %.9g %.9g %.9g %.9g %.9g\n", frame.position.x, frame.position.y, frame.position.z,
+                frame.yaw, frame.pitch, frame.fov);
+    }
+    return fclose(file) == 0;
+}
+
+bool CameraPath::Load(const std::string& path)
+{
+    std::ifstream stream(path);
+    if (!stream)
+    {
+        std::cout << "Could not open " << path << std::endl;
+        return false;
+    }
+    Clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(stream, line))
+    {
+        lineNumber++;
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::istringstream fields(line);
+        std::string kind;
+        fields >> kind;
+        if (kind == "param")
+        {
+            ParamChange change;
+            change.frame = GetNumFrames();
+            if (fields >> change.name >> change.value)
+            {
+                m_Changes.push_back(change);
+                m_Current[change.name] = change.value;
+                continue;
+            }
+        }
+        else if (kind == "frame")
+        {
+            CameraPathFrame frame;
+            if (fields >> frame.position.x >> frame.position.y >> frame.position.z >> frame.yaw >> frame.pitch >> frame.fov)
+            {
+                m_Frames.push_back(frame);
+                continue;
+            }
+        }
+        std::cout << path << ":" << lineNumber << ": could not parse \"" << line << "\"" << std::endl;
+        Clear();
+        return false;
+    }
+    // Changes after the last frame would never be applied
+    while (!m_Changes.empty() && m_Changes.back().frame >= GetNumFrames())
+    {
+        m_Changes.pop_back();
+    }
+    return GetNumFrames() > 0;
+}
+
+void CameraPath::GetChanges(int frame, CameraPathParams& changes) const
+{
+    changes.clear();
+    std::vector<ParamChange>::const_iterator it = std::lower_bound(m_Changes.begin(), m_Changes.end(), frame,
+        [](const ParamChange& change, int value) { return change.frame < value; });
+    for (; it != m_Changes.end() && it->frame == frame; ++it)
+    {
+        changes[it->name] = it->value;
+    }
+}
\ No newline at end of file
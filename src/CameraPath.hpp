@@ -0,0 +1,53 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+struct CameraPathFrame
+{
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+    float fov;
+};
+
+// Named viewer parameters (mode, fiber counts, rotations, toggles); the viewer decides what goes in
+typedef std::map<std::string, float> CameraPathParams;
+
+// A recorded fly-through: one camera state per frame plus the parameter changes made along the way.
+// Replaying it at a fixed timestep renders the same frames on every run, so frame times from two builds
+// can be compared directly. Stored as text:
+//   param <name> <value>              (applies from the next frame on)
+//   frame <x> <y> <z> <yaw> <pitch> <fov>
+class CameraPath
+{
+public:
+    static const double TimeStep; //seconds of simulated time per replayed frame
+
+    void Clear();
+    // Stores the camera and whichever parameters differ from the previous frame
+    void AddFrame(const CameraPathFrame& frame, const CameraPathParams& params);
+
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path);
+
+    inline int GetNumFrames() const { return (int)m_Frames.size(); }
+    inline const CameraPathFrame& GetFrame(int frame) const { return m_Frames[frame]; }
+    // Parameters that change at this frame (all of them at frame 0)
+    void GetChanges(int frame, CameraPathParams& changes) const;
+
+private:
+    struct ParamChange
+    {
+        int frame;
+        std::string name;
+        float value;
+    };
+
+    std::vector<CameraPathFrame> m_Frames;
+    std::vector<ParamChange> m_Changes; //ordered by frame
+    CameraPathParams m_Current;         //values after the last recorded frame
+};
\ No newline at end of file
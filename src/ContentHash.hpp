@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// 64-bit content hash for float buffers, cheap enough to run while the buffers are produced: two
+// multiply-xorshift lanes over 8-byte words, a few cycles per vertex. Words are read in host byte
+// order, so recorded hashes hold for little-endian hosts.
+
+const uint64_t CONTENT_HASH_SEED = 0x6A09E667F3BCC908ull;
+
+inline uint64_t MixHash(uint64_t hash, uint64_t word)
+{
+    hash ^= word;
+    hash *= 0x9E3779B97F4A7C15ull;
+    return hash ^ (hash >> 29);
+}
+
+// Final avalanche, MurmurHash3's fmix64
+inline uint64_t FinalizeHash(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+inline uint64_t HashFloats(uint64_t seed, const float* values, size_t count)
+{
+    uint64_t lanes[2] = { seed, seed ^ (uint64_t)count };
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        uint64_t words[2];
+        memcpy(words, values + i, sizeof(words));
+        lanes[0] = MixHash(lanes[0], words[0]);
+        lanes[1] = MixHash(lanes[1], words[1]);
+    }
+    for (; i < count; i++)
+    {
+        uint32_t word;
+        memcpy(&word, values + i, sizeof(word));
+        lanes[0] = MixHash(lanes[0], word);
+    }
+    return MixHash(lanes[0], lanes[1]);
+}
\ No newline at end of file
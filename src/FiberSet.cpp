@@ -0,0 +1,196 @@
+#include "FiberSet.hpp"
+#include "GlobalFunctions.hpp"
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
+#include "ContentHash.hpp"
+
+#include <algorithm>
+
+FiberSetView FiberSet::GetView() const
+{
+    FiberSetView view;
+    view.numFibers = GetNumFibers();
+    view.numVertices = GetNumVertices();
+    view.basePoints = basePoints.empty() ? nullptr : &basePoints[0];
+    view.colors = colors.empty() ? nullptr : &colors[0];
+    view.firsts = firsts.empty() ? nullptr : &firsts[0];
+    view.counts = counts.empty() ? nullptr : &counts[0];
+    view.vertices = vertices.empty() ? nullptr : &vertices[0];
+    view.fiberHashes = fiberHashes.size() != counts.size() || fiberHashes.empty() ? nullptr : &fiberHashes[0];
+    return view;
+}
+
+void FiberSet::Clear()
+{
+    basePoints.clear();
+    colors.clear();
+    firsts.clear();
+    counts.clear();
+    vertices.clear();
+    fiberHashes.clear();
+}
+
+uint64_t FiberSet::GetContentHash() const
+{
+    return GetFiberSetHash(GetView());
+}
+
+uint64_t HashFiberVertices(const float* vertices, unsigned int count)
+{
+    return HashFloats(CONTENT_HASH_SEED, vertices, (size_t)count * 3);
+}
+
+uint64_t FinishFiberHash(uint64_t vertexHash, const float* color)
+{
+    return FinalizeHash(HashFloats(vertexHash, color, 4));
+}
+
+uint64_t HashFiber(const float* vertices, unsigned int count, const float* color)
+{
+    return FinishFiberHash(HashFiberVertices(vertices, count), color);
+}
+
+uint64_t CombineFiberHashes(const uint64_t* hashes, size_t count)
+{
+    uint64_t hash = CONTENT_HASH_SEED ^ (uint64_t)count;
+    for (size_t i = 0; i < count; i++)
+    {
+        hash = MixHash(hash, hashes[i]);
+    }
+    return FinalizeHash(hash);
+}
+
+uint64_t GetFiberSetHash(const FiberSetView& fiberSet)
+{
+    if (fiberSet.fiberHashes)
+        return CombineFiberHashes(fiberSet.fiberHashes, fiberSet.numFibers);
+    std::vector<uint64_t> hashes(fiberSet.numFibers);
+    for (unsigned int i = 0; i < fiberSet.numFibers; i++)
+    {
+        hashes[i] = HashFiber(fiberSet.vertices + (size_t)fiberSet.firsts[i] * 3, fiberSet.counts[i], fiberSet.colors + i * 4);
+    }
+    return CombineFiberHashes(hashes.empty() ? nullptr : &hashes[0], hashes.size());
+}
+
+unsigned int GetFiberSampleCount(double phiInc)
+{
+    unsigned int count = 0;
+    for (double phi = 0; phi <= 2 * PI; phi += phiInc)
+    {
+        count++;
+    }
+    return count;
+}
+
+void LiftFiber(const std::vector<double>& point, double phiInc, std::vector<double>& samples)
+{
+    double x = point[0];
+    double y = point[1];
+    double z = point[2];
+    samples.clear();
+    for (double phi = 0; phi <= 2 * PI; phi += phiInc)
+    {
+        double f = 1 / sqrt(2 * (1 + z));
+        samples.push_back(cos(phi) * (1 + z) * f);
+        samples.push_back((sin(phi) * x - cos(phi) * y) * f);
+        samples.push_back((cos(phi) * x + sin(phi) * y) * f);
+        samples.push_back(sin(phi) * (1 + z) * f);
+    }
+}
+
+void BuildFiberSet(const std::vector<std::vector<double>>& points, FiberSet& fiberSet, double phiInc, FiberPrecision precision)
+{
+    BuildFibers(points, 0, points.size(), fiberSet, phiInc, precision);
+}
+
+static void ResizeFiberSet(FiberSet& fiberSet, size_t numFibers, unsigned int samples)
+{
+    fiberSet.basePoints.resize(numFibers * 3);
+    fiberSet.colors.resize(numFibers * 4);
+    fiberSet.firsts.resize(numFibers);
+    fiberSet.counts.resize(numFibers);
+    fiberSet.vertices.resize(numFibers * samples * 3);
+    fiberSet.fiberHashes.resize(numFibers);
+}
+
+// Fills fibers [first, first + (end - begin)) of an already sized set from points [begin, end)
+template<typename Real>
+static void LiftFibers(const std::vector<std::vector<double>>& points, size_t begin, size_t end, FiberSet& fiberSet, size_t first, double phiInc)
+{
+    // sin/cos of phi are shared by every fiber, so they are computed once per call
+    std::vector<Real> cosPhi, sinPhi;
+    for (double phi = 0; phi <= 2 * PI; phi += phiInc)
+    {
+        cosPhi.push_back((Real)cos(phi));
+        sinPhi.push_back((Real)sin(phi));
+    }
+    unsigned int samples = (unsigned int)cosPhi.size();
+    unsigned int numFibers = (unsigned int)(end - begin);
+
+    for (size_t k = 0; k < numFibers; k++)
+    {
+        const std::vector<double>& point = points[begin + k];
+        size_t i = first + k;
+        Real x = (Real)point[0];
+        Real y = (Real)point[1];
+        Real z = (Real)point[2];
+        Real f = 1 / sqrt(2 * (1 + z));
+
+        fiberSet.basePoints[i * 3 + 0] = (float)x;
+        fiberSet.basePoints[i * 3 + 1] = (float)y;
+        fiberSet.basePoints[i * 3 + 2] = (float)z;
+        std::vector<double> color = GetColor(point);
+        for (int c = 0; c < 4; c++)
+        {
+            fiberSet.colors[i * 4 + c] = (float)color[c];
+        }
+        fiberSet.firsts[i] = (unsigned int)(i * samples);
+        fiberSet.counts[i] = samples;
+
+        float* out = &fiberSet.vertices[i * samples * 3];
+        for (unsigned int j = 0; j < samples; j++)
+        {
+            // Point on S3, then stereographic projection from (0, 0, 0, 1)
+            Real q0 = cosPhi[j] * (1 + z) * f;
+            Real q1 = (sinPhi[j] * x - cosPhi[j] * y) * f;
+            Real q2 = (cosPhi[j] * x + sinPhi[j] * y) * f;
+            Real q3 = sinPhi[j] * (1 + z) * f;
+            Real s = (Real)FIBER_PROJECTION_SCALE / (1 - q3);
+            out[j * 3 + 0] = (float)(q0 * s);
+            out[j * 3 + 1] = (float)(q1 * s);
+            out[j * 3 + 2] = (float)(q2 * s);
+        }
+        // Hashed while the fiber is still in cache
+        fiberSet.fiberHashes[i] = HashFiber(out, samples, &fiberSet.colors[i * 4]);
+    }
+}
+
+void BuildFibers(const std::vector<std::vector<double>>& points, size_t begin, size_t end, FiberSet& fiberSet, double phiInc, FiberPrecision precision)
+{
+    PROFILE_FUNCTION();
+    ResizeFiberSet(fiberSet, end - begin, GetFiberSampleCount(phiInc));
+    if (precision == FiberPrecision::Float)
+        LiftFibers<float>(points, begin, end, fiberSet, 0, phiInc);
+    else
+        LiftFibers<double>(points, begin, end, fiberSet, 0, phiInc);
+}
+
+void BuildFiberSet(const std::vector<std::vector<double>>& points, FiberSet& fiberSet, double phiInc, FiberPrecision precision, ThreadPool& pool)
+{
+    ResizeFiberSet(fiberSet, points.size(), GetFiberSampleCount(phiInc));
+
+    // Fibers are independent and every chunk writes its own slice, so the result does not depend on the thread count
+    const size_t chunkFibers = 256;
+    for (size_t begin = 0; begin < points.size(); begin += chunkFibers)
+    {
+        size_t end = std::min(begin + chunkFibers, points.size());
+        pool.Submit([&points, &fiberSet, begin, end, phiInc, precision]() {
+            PROFILE_SCOPE("BuildFiberSet chunk");
+            if (precision == FiberPrecision::Float)
+                LiftFibers<float>(points, begin, end, fiberSet, begin, phiInc);
+            else
+                LiftFibers<double>(points, begin, end, fiberSet, begin, phiInc);
+        });
+    }
+    pool.Wait();
+}
\ No newline at end of file
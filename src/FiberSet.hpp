@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+#define FIBER_PHI_STEP 0.02             //angular step along each fiber, as in Hopf::InverseHopfMap
+#define FIBER_PROJECTION_SCALE 400.0    //scale applied after stereographic projection
+
+// Read-only view of a fiber set. Fiber i owns vertices [firsts[i], firsts[i] + counts[i]);
+// the pointers may come from a FiberSet or straight from a memory-mapped file.
+struct FiberSetView
+{
+    unsigned int numFibers = 0;
+    size_t numVertices = 0;
+    const float* basePoints = nullptr;      //xyz per fiber, on S2
+    const float* colors = nullptr;          //rgba per fiber
+    const unsigned int* firsts = nullptr;
+    const unsigned int* counts = nullptr;
+    const float* vertices = nullptr;        //xyz per vertex, projected to R3
+    const int16_t* quantizedVertices = nullptr; //snorm16 xyz per vertex against fiberBounds, from quantized files
+    const float* fiberBounds = nullptr;     //min xyz then max xyz per fiber, with quantizedVertices
+    const uint64_t* fiberHashes = nullptr;  //optional, see HashFiber
+};
+
+// CPU-side fibers for a set of base points, packed back to back so they can be saved, exported or
+// uploaded without touching GL.
+struct FiberSet
+{
+    std::vector<float> basePoints;
+    std::vector<float> colors;
+    std::vector<unsigned int> firsts;
+    std::vector<unsigned int> counts;
+    std::vector<float> vertices;
+    std::vector<uint64_t> fiberHashes;      //HashFiber of every fiber, filled in as the fibers are built
+
+    inline unsigned int GetNumFibers() const { return (unsigned int)counts.size(); }
+    inline size_t GetNumVertices() const { return vertices.size() / 3; }
+    FiberSetView GetView() const;
+    void Clear();
+    uint64_t GetContentHash() const;
+};
+
+enum class FiberPrecision
+{
+    Double,     //reference math, matches Hopf::InverseHopfMap
+    Float       //single precision throughout; faster, ~1e-4 relative error after projection
+};
+
+// Content hash of one fiber's vertices and color, split so producers that write them at different
+// times (Hopf) can hash as they go. HashFiber = FinishFiberHash(HashFiberVertices(...), color).
+uint64_t HashFiberVertices(const float* vertices, unsigned int count);
+uint64_t FinishFiberHash(uint64_t vertexHash, const float* color);
+uint64_t HashFiber(const float* vertices, unsigned int count, const float* color);
+// Ordered combination of per-fiber hashes, so a set's hash does not depend on how its fibers were scheduled
+uint64_t CombineFiberHashes(const uint64_t* hashes, size_t count);
+// Uses the view's fiberHashes when present, otherwise hashes every fiber
+uint64_t GetFiberSetHash(const FiberSetView& fiberSet);
+
+// Number of samples per fiber for a phi step (the same loop bounds Hopf::InverseHopfMap uses)
+unsigned int GetFiberSampleCount(double phiInc);
+
+// Reference lift of one base point, the loop Hopf::InverseHopfMap runs: xyzw on S3 per sample, in double.
+// The fast paths are checked against it (see Verify.hpp).
+void LiftFiber(const std::vector<double>& point, double phiInc, std::vector<double>& samples);
+
+// Lifts every base point through the inverse Hopf map and stereographically projects the fiber
+void BuildFiberSet(const std::vector<std::vector<double>>& points, FiberSet& fiberSet, double phiInc = FIBER_PHI_STEP,
+                   FiberPrecision precision = FiberPrecision::Double);
+
+// Same, split into chunks across the pool's threads; the output is identical to the serial build
+void BuildFiberSet(const std::vector<std::vector<double>>& points, FiberSet& fiberSet, double phiInc, FiberPrecision precision, ThreadPool& pool);
+
+// Same for points [begin, end) only; firsts are relative to the chunk. Used to stream large sets.
+void BuildFibers(const std::vector<std::vector<double>>& points, size_t begin, size_t end, FiberSet& fiberSet, double phiInc = FIBER_PHI_STEP,
+                 FiberPrecision precision = FiberPrecision::Double);
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "FiberSetFile.hpp"
+#include "VertexFormat.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(FiberSetFileHeader) == 128, "FiberSetFileHeader must stay 128 bytes");
+
+static uint64_t AlignUp(uint64_t offset)
+{
+    return (offset + FIBER_SET_ALIGNMENT - 1) & ~(uint64_t)(FIBER_SET_ALIGNMENT - 1);
+}
+
+static bool WriteSection(FILE* file, uint64_t& position, uint64_t offset, const void* data, size_t size)
+{
+    static const unsigned char zeros[FIBER_SET_ALIGNMENT] = { 0 };
+    if (offset > position)
+    {
+        fwrite(zeros, 1, (size_t)(offset - position), file);
+    }
+    if (size > 0)
+    {
+        fwrite(data, 1, size, file);
+    }
+    position = offset + size;
+    return ferror(file) == 0;
+}
+
+bool SaveFiberSet(const std::string& path, const FiberSetView& fiberSet, bool quantize)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        std::cout << "SaveFiberSet: could not open " << path << std::endl;
+        return false;
+    }
+    setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+    uint64_t numFibers = fiberSet.numFibers;
+    uint64_t numVertices = fiberSet.numVertices;
+
+    FiberSetFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FIBER_SET_MAGIC, sizeof(FIBER_SET_MAGIC));
+    header.version = FIBER_SET_VERSION;
+    header.flags = quantize ? FIBER_SET_QUANTIZED : 0;
+    header.numFibers = fiberSet.numFibers;
+    header.byteOrder = 0x01020304;
+    header.numVertices = numVertices;
+    header.basePointsOffset = AlignUp(sizeof(header));
+    header.colorsOffset = AlignUp(header.basePointsOffset + numFibers * 3 * sizeof(float));
+    header.firstsOffset = AlignUp(header.colorsOffset + numFibers * 4 * sizeof(float));
+    header.countsOffset = AlignUp(header.firstsOffset + numFibers * sizeof(uint32_t));
+    uint64_t next = AlignUp(header.countsOffset + numFibers * sizeof(uint32_t));
+    if (quantize)
+    {
+        header.boundsOffset = next;
+        next = AlignUp(header.boundsOffset + numFibers * 6 * sizeof(float));
+    }
+    header.verticesOffset = next;
+    header.fileSize = header.verticesOffset + numVertices * 3 * (quantize ? sizeof(int16_t) : sizeof(float));
+
+    uint64_t position = 0;
+    bool ok = WriteSection(file, position, 0, &header, sizeof(header));
+    ok = ok && WriteSection(file, position, header.basePointsOffset, fiberSet.basePoints, numFibers * 3 * sizeof(float));
+    ok = ok && WriteSection(file, position, header.colorsOffset, fiberSet.colors, numFibers * 4 * sizeof(float));
+    ok = ok && WriteSection(file, position, header.firstsOffset, fiberSet.firsts, numFibers * sizeof(uint32_t));
+    ok = ok && WriteSection(file, position, header.countsOffset, fiberSet.counts, numFibers * sizeof(uint32_t));
+
+    if (!quantize)
+    {
+        ok = ok && WriteSection(file, position, header.verticesOffset, fiberSet.vertices, numVertices * 3 * sizeof(float));
+    }
+    else
+    {
+        // Per-fiber bounds keep precision for fibers near the projection pole, which span huge distances
+        std::vector<float> bounds(numFibers * 6);
+        for (uint64_t i = 0; i < numFibers; i++)
+        {
+            const float* vertices = fiberSet.vertices + (size_t)fiberSet.firsts[i] * 3;
+            for (int axis = 0; axis < 3; axis++)
+            {
+                float minimum = fiberSet.counts[i] > 0 ? vertices[axis] : 0.0f;
+                float maximum = minimum;
+                for (unsigned int j = 1; j < fiberSet.counts[i]; j++)
+                {
+                    float value = vertices[j * 3 + axis];
+                    minimum = value < minimum ? value : minimum;
+                    maximum = value > maximum ? value : maximum;
+                }
+                bounds[i * 6 + axis] = minimum;
+                bounds[i * 6 + 3 + axis] = maximum;
+            }
+        }
+        ok = ok && WriteSection(file, position, header.boundsOffset, &bounds[0], bounds.size() * sizeof(float));
+
+        ok = ok && WriteSection(file, position, header.verticesOffset, nullptr, 0);
+        std::vector<int16_t> quantized;
+        for (uint64_t i = 0; i < numFibers && ok; i++)
+        {
+            const float* vertices = fiberSet.vertices + (size_t)fiberSet.firsts[i] * 3;
+            quantized.resize((size_t)fiberSet.counts[i] * 3);
+            for (unsigned int j = 0; j < fiberSet.counts[i]; j++)
+            {
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    quantized[j * 3 + axis] = QuantizeSnorm16(vertices[j * 3 + axis], bounds[i * 6 + axis], bounds[i * 6 + 3 + axis]);
+                }
+            }
+            if (!quantized.empty())
+            {
+                fwrite(&quantized[0], sizeof(int16_t), quantized.size(), file);
+            }
+        }
+        ok = ok && ferror(file) == 0;
+    }
+
+    ok = fclose(file) == 0 && ok;
+    if (!ok)
+    {
+        std::cout << "SaveFiberSet: failed writing " << path << std::endl;
+    }
+    return ok;
+}
+
+MappedFiberSet::MappedFiberSet()
+    : m_Data(nullptr), m_Size(0), m_Header(nullptr),
+#ifdef _WIN32
+      m_File(INVALID_HANDLE_VALUE), m_Mapping(nullptr)
+#else
+      m_File(-1)
+#endif
+{
+}
+
+MappedFiberSet::~MappedFiberSet()
+{
+    Close();
+}
+
+// Whether count elements of size bytes at offset lie within the mapping. Written so a crafted header
+// cannot overflow the sum, and sections must keep the alignment they are read with.
+static bool SectionFits(uint64_t offset, uint64_t count, uint64_t size, size_t mapped)
+{
+    return offset % FIBER_SET_ALIGNMENT == 0 && offset <= mapped && count <= (mapped - offset) / size;
+}
+
+bool MappedFiberSet::Open(const std::string& path)
+{
+    Close();
+#ifdef _WIN32
+    m_File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER fileSize;
+    if (m_File == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_File, &fileSize))
+    {
+        std::cout << "MappedFiberSet: could not open " << path << std::endl;
+        Close();
+        return false;
+    }
+    m_Size = (size_t)fileSize.QuadPart;
+    m_Mapping = m_Size > 0 ? CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    m_Data = m_Mapping ? (const unsigned char*)MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+#else
+    m_File = open(path.c_str(), O_RDONLY);
+    struct stat status;
+    if (m_File < 0 || fstat(m_File, &status) != 0)
+    {
+        std::cout << "MappedFiberSet: could not open " << path << std::endl;
+        Close();
+        return false;
+    }
+    m_Size = (size_t)status.st_size;
+    if (m_Size > 0)
+    {
+        void* data = mmap(nullptr, m_Size, PROT_READ, MAP_SHARED, m_File, 0);
+        m_Data = data == MAP_FAILED ? nullptr : (const unsigned char*)data;
+    }
+#endif
+    if (!m_Data || m_Size < sizeof(FiberSetFileHeader))
+    {
+        std::cout << "MappedFiberSet: could not map " << path << std::endl;
+        Close();
+        return false;
+    }
+
+    const FiberSetFileHeader* header = (const FiberSetFileHeader*)m_Data;
+    bool quantized = (header->flags & FIBER_SET_QUANTIZED) != 0;
+    uint64_t numFibers = header->numFibers;
+    uint64_t vertexSize = 3 * (quantized ? sizeof(int16_t) : sizeof(float));
+    bool valid = memcmp(header->magic, FIBER_SET_MAGIC, sizeof(FIBER_SET_MAGIC)) == 0
+        && header->version == FIBER_SET_VERSION
+        && header->byteOrder == 0x01020304
+        && header->fileSize <= m_Size
+        && SectionFits(header->basePointsOffset, numFibers, 3 * sizeof(float), m_Size)
+        && SectionFits(header->colorsOffset, numFibers, 4 * sizeof(float), m_Size)
+        && SectionFits(header->firstsOffset, numFibers, sizeof(uint32_t), m_Size)
+        && SectionFits(header->countsOffset, numFibers, sizeof(uint32_t), m_Size)
+        && (!quantized || SectionFits(header->boundsOffset, numFibers, 6 * sizeof(float), m_Size))
+        && SectionFits(header->verticesOffset, header->numVertices, vertexSize, m_Size);
+    if (valid)
+    {
+        const uint32_t* firsts = (const uint32_t*)(m_Data + header->firstsOffset);
+        const uint32_t* counts = (const uint32_t*)(m_Data + header->countsOffset);
+        for (uint64_t i = 0; i < numFibers && valid; i++)
+        {
+            valid = (uint64_t)firsts[i] + counts[i] <= header->numVertices;
+        }
+    }
+    if (!valid)
+    {
+        std::cout << "MappedFiberSet: " << path << " is not a valid version " << FIBER_SET_VERSION << " fiber set" << std::endl;
+        Close();
+        return false;
+    }
+    m_Header = header;
+    return true;
+}
+
+void MappedFiberSet::Close()
+{
+#ifdef _WIN32
+    if (m_Data)
+        UnmapViewOfFile(m_Data);
+    if (m_Mapping)
+        CloseHandle(m_Mapping);
+    if (m_File != INVALID_HANDLE_VALUE)
+        CloseHandle(m_File);
+    m_Mapping = nullptr;
+    m_File = INVALID_HANDLE_VALUE;
+#else
+    if (m_Data)
+        munmap((void*)m_Data, m_Size);
+    if (m_File >= 0)
+        close(m_File);
+    m_File = -1;
+#endif
+    m_Data = nullptr;
+    m_Size = 0;
+    m_Header = nullptr;
+    m_Dequantized.clear();
+}
+
+const int16_t* MappedFiberSet::GetQuantizedVertices() const
+{
+    return IsQuantized() ? (const int16_t*)(m_Data + m_Header->verticesOffset) : nullptr;
+}
+
+const float* MappedFiberSet::GetFiberBounds() const
+{
+    return IsQuantized() ? (const float*)(m_Data + m_Header->boundsOffset) : nullptr;
+}
+
+FiberSetView MappedFiberSet::GetRawView() const
+{
+    FiberSetView view;
+    if (!m_Header)
+    {
+        return view;
+    }
+    view.numFibers = m_Header->numFibers;
+    view.numVertices = (size_t)m_Header->numVertices;
+    view.basePoints = (const float*)(m_Data + m_Header->basePointsOffset);
+    view.colors = (const float*)(m_Data + m_Header->colorsOffset);
+    view.firsts = (const unsigned int*)(m_Data + m_Header->firstsOffset);
+    view.counts = (const unsigned int*)(m_Data + m_Header->countsOffset);
+    if (IsQuantized())
+    {
+        view.quantizedVertices = GetQuantizedVertices();
+        view.fiberBounds = GetFiberBounds();
+    }
+    else
+    {
+        view.vertices = (const float*)(m_Data + m_Header->verticesOffset);
+    }
+    return view;
+}
+
+FiberSetView MappedFiberSet::GetView()
+{
+    FiberSetView view = GetRawView();
+    if (!IsQuantized())
+    {
+        return view;
+    }
+
+    if (m_Dequantized.empty() && view.numVertices > 0)
+    {
+        const int16_t* quantized = GetQuantizedVertices();
+        const float* bounds = GetFiberBounds();
+        m_Dequantized.resize(view.numVertices * 3);
+        for (unsigned int i = 0; i < view.numFibers; i++)
+        {
+            size_t first = view.firsts[i];
+            for (unsigned int j = 0; j < view.counts[i]; j++)
+            {
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    m_Dequantized[(first + j) * 3 + axis] = DequantizeSnorm16(quantized[(first + j) * 3 + axis],
+                        bounds[i * 6 + axis], bounds[i * 6 + 3 + axis]);
+                }
+            }
+        }
+    }
+    view.vertices = m_Dequantized.empty() ? nullptr : &m_Dequantized[0];
+    return view;
+}
\ No newline at end of file
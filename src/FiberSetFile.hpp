@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "FiberSet.hpp"
+
+// Binary fiber-set file (.hfs), version 1, little endian.
+//
+//   FiberSetFileHeader   128 bytes
+//   base points          float[3 * numFibers]
+//   colors               float[4 * numFibers]
+//   firsts               uint32[numFibers]
+//   counts               uint32[numFibers]
+//   fiber bounds         float[6 * numFibers], min xyz then max xyz (quantized files only)
+//   vertices             float[3 * numVertices], or snorm16[3 * numVertices] mapped onto the fiber bounds
+//
+// Every section starts on a 64-byte boundary, so a mapped file can be handed to VertexBuffer as is.
+#define FIBER_SET_MAGIC "HOPFFIB"
+#define FIBER_SET_VERSION 1
+#define FIBER_SET_ALIGNMENT 64
+
+enum FiberSetFlags
+{
+    FIBER_SET_QUANTIZED = 1 << 0
+};
+
+struct FiberSetFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t numFibers;
+    uint32_t byteOrder;             //0x01020304 as written by the producer
+    uint64_t numVertices;
+    uint64_t basePointsOffset;
+    uint64_t colorsOffset;
+    uint64_t firstsOffset;
+    uint64_t countsOffset;
+    uint64_t boundsOffset;          //0 unless quantized
+    uint64_t verticesOffset;
+    uint64_t fileSize;
+    uint8_t reserved[40];
+};
+
+bool SaveFiberSet(const std::string& path, const FiberSetView& fiberSet, bool quantize);
+
+// Maps a .hfs file read-only. Float files are used in place; quantized files keep their snorm16
+// vertices in the mapping and only expand them when GetView() needs float positions.
+// GetRawView() never expands: it points at the float or the snorm16 section as stored.
+class MappedFiberSet
+{
+public:
+    MappedFiberSet();
+    ~MappedFiberSet();
+
+    bool Open(const std::string& path);
+    void Close();
+
+    FiberSetView GetView();
+    FiberSetView GetRawView() const;
+    inline bool IsQuantized() const { return m_Header && (m_Header->flags & FIBER_SET_QUANTIZED); }
+    inline const FiberSetFileHeader* GetHeader() const { return m_Header; }
+    const int16_t* GetQuantizedVertices() const;
+    const float* GetFiberBounds() const;
+
+private:
+    const unsigned char* m_Data;
+    size_t m_Size;
+    const FiberSetFileHeader* m_Header;
+    std::vector<float> m_Dequantized;
+#ifdef _WIN32
+    void* m_File;
+    void* m_Mapping;
+#else
+    int m_File;
+#endif
+};
\ No newline at end of file
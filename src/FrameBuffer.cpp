@@ -2,18 +2,45 @@
 #include <iostream>
 
 FrameBuffer::FrameBuffer()
-    :m_RendererID(0), m_TextureID(0)
+    :m_RendererID(0), m_TextureID(0), m_DepthID(0), m_Width(0), m_Height(0)
 {
     glGenFramebuffers(1, &m_RendererID);
 }
 
 FrameBuffer::FrameBuffer(unsigned int m_RendererID)
-    : m_RendererID(m_RendererID), m_TextureID(0)
+    : m_RendererID(m_RendererID), m_TextureID(0), m_DepthID(0), m_Width(0), m_Height(0)
 {
 }
 
 FrameBuffer::~FrameBuffer()
 {
+    Delete();
+}
+
+FrameBuffer::FrameBuffer(FrameBuffer&& other) noexcept
+    : m_RendererID(other.m_RendererID), m_TextureID(other.m_TextureID), m_DepthID(other.m_DepthID),
+      m_Width(other.m_Width), m_Height(other.m_Height)
+{
+    other.m_RendererID = 0;
+    other.m_TextureID = 0;
+    other.m_DepthID = 0;
+}
+
+FrameBuffer& FrameBuffer::operator=(FrameBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        Delete();
+        m_RendererID = other.m_RendererID;
+        m_TextureID = other.m_TextureID;
+        m_DepthID = other.m_DepthID;
+        m_Width = other.m_Width;
+        m_Height = other.m_Height;
+        other.m_RendererID = 0;
+        other.m_TextureID = 0;
+        other.m_DepthID = 0;
+    }
+    return *this;
 }
 
 void FrameBuffer::Bind() const
@@ -26,17 +53,27 @@ void FrameBuffer::Unbind() const
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-void FrameBuffer::Delete() const
+void FrameBuffer::Delete()
 {
-    glDeleteFramebuffers(1, &m_RendererID);
+    if (m_RendererID)
+        glDeleteFramebuffers(1, &m_RendererID);
+    if (m_TextureID)
+        glDeleteTextures(1, &m_TextureID);
+    if (m_DepthID)
+        glDeleteRenderbuffers(1, &m_DepthID);
+    m_RendererID = 0;
+    m_TextureID = 0;
+    m_DepthID = 0;
 }
 
-void FrameBuffer::AttachTexture()
+void FrameBuffer::AttachTexture(int width, int height)
 {
+    m_Width = width;
+    m_Height = height;
     Bind();
     glGenTextures(1, &m_TextureID);
     glBindTexture(GL_TEXTURE_2D, m_TextureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1920, 1080, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, m_Width, m_Height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -46,4 +83,27 @@ void FrameBuffer::AttachTexture()
         std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void FrameBuffer::AttachDepthBuffer()
+{
+    Bind();
+    glGenRenderbuffers(1, &m_DepthID);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_DepthID);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Width, m_Height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthID);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void FrameBuffer::ReadPixels(std::vector<unsigned char>& pixels) const
+{
+    pixels.resize((size_t)m_Width * m_Height * 3);
+    Bind();
+    GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+    GLCall(glReadPixels(0, 0, m_Width, m_Height, GL_RGB, GL_UNSIGNED_BYTE, &pixels[0]));
 }
\ No newline at end of file
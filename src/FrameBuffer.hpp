@@ -1,22 +1,36 @@
 #pragma once
 
+#include <vector>
+
 #include "Renderer.hpp"
 
+// Owns its framebuffer and attachments: move-only, deleted in the destructor
 class FrameBuffer
 {
 public:
     FrameBuffer();
-    FrameBuffer(unsigned int m_RendererID);
+    FrameBuffer(unsigned int m_RendererID); //takes ownership of an existing framebuffer
     ~FrameBuffer();
+    FrameBuffer(FrameBuffer&& other) noexcept;
+    FrameBuffer& operator=(FrameBuffer&& other) noexcept;
+    FrameBuffer(const FrameBuffer&) = delete;
+    FrameBuffer& operator=(const FrameBuffer&) = delete;
 
     void Bind() const;
     void Unbind() const;
-    void Delete() const;
+    void Delete(); //releases everything early; safe to call more than once
 
-    void AttachTexture();
+    void AttachTexture(int width = 1920, int height = 1080);
+    void AttachDepthBuffer();
+    void ReadPixels(std::vector<unsigned char>& pixels) const; //RGB, bottom row first
     unsigned int GetTextureID() const { return m_TextureID; }
+    int GetWidth() const { return m_Width; }
+    int GetHeight() const { return m_Height; }
 
 private:
     unsigned int m_RendererID = 0;
     unsigned int m_TextureID = 0;
+    unsigned int m_DepthID = 0;
+    int m_Width = 0;
+    int m_Height = 0;
 };
\ No newline at end of file
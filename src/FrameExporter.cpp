@@ -0,0 +1,139 @@
+#include "FrameExporter.hpp"
+#include "ImageWriter.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+static void MakeDirectory(const std::string& path)
+{
+#ifdef _WIN32
+    _mkdir(path.c_str());
+#else
+    mkdir(path.c_str(), 0755);
+#endif
+}
+
+// Turns a bottom-up RGBA readback into a top-down RGB PNG, one row at a time
+static bool EncodeFrame(const std::string& path, const std::vector<unsigned char>& pixels, int width, int height)
+{
+    ImageWriter writer;
+    if (!writer.Open(path, width, height, 3))
+    {
+        return false;
+    }
+    std::vector<unsigned char> row((size_t)width * 3);
+    for (int y = height - 1; y >= 0; y--)
+    {
+        const unsigned char* source = &pixels[(size_t)y * width * 4];
+        for (int x = 0; x < width; x++)
+        {
+            row[x * 3 + 0] = source[x * 4 + 0];
+            row[x * 3 + 1] = source[x * 4 + 1];
+            row[x * 3 + 2] = source[x * 4 + 2];
+        }
+        writer.WriteRows(&row[0], 1);
+    }
+    return writer.Close();
+}
+
+FrameExporter::FrameExporter(const std::string& directory, int width, int height, unsigned int numEncoders, int ringSize)
+    : m_Directory(directory), m_Width(width), m_Height(height), m_FramesCaptured(0), m_Finished(false), m_Failed(false),
+      m_Readback(width, height, ringSize), m_Encoders(numEncoders, numEncoders == 0 ? 8 : 2 * numEncoders)
+{
+    MakeDirectory(m_Directory);
+}
+
+FrameExporter::~FrameExporter()
+{
+    if (!m_Finished)
+    {
+        Finish(0.0);
+    }
+}
+
+std::string FrameExporter::FramePath(long long frame) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "frame_%06lld.png", frame);
+    return m_Directory + "/" + name;
+}
+
+void FrameExporter::CaptureFrame()
+{
+    Collect(false); //hand off whatever the GPU already finished
+    if (m_Readback.GetInFlight() == m_Readback.GetRingSize())
+    {
+        Collect(true); //ring is full: the oldest read was issued ringSize frames ago and is normally done
+    }
+    if (m_Readback.Request(0, 0, m_Width, m_Height, m_FramesCaptured))
+    {
+        m_FramesCaptured++;
+    }
+}
+
+void FrameExporter::Collect(bool wait)
+{
+    while (m_Readback.GetInFlight() > 0)
+    {
+        std::shared_ptr<std::vector<unsigned char>> pixels(new std::vector<unsigned char>());
+        int width, height;
+        long long frame;
+        if (!m_Readback.Retrieve(*pixels, width, height, frame, wait))
+        {
+            return;
+        }
+        std::string path = FramePath(frame);
+        std::atomic<bool>* failed = &m_Failed;
+        m_Encoders.Submit([pixels, path, width, height, failed]() {
+            if (!EncodeFrame(path, *pixels, width, height))
+            {
+                *failed = true;
+            }
+        });
+        if (wait)
+        {
+            return; //only needed to free one slot
+        }
+    }
+}
+
+bool FrameExporter::Finish(double fps)
+{
+    while (m_Readback.GetInFlight() > 0)
+    {
+        Collect(true);
+    }
+    m_Encoders.Wait();
+    m_Finished = true;
+
+    std::string manifestPath = m_Directory + "/manifest.json";
+    FILE* manifest = fopen(manifestPath.c_str(), "w");
+    if (!manifest)
+    {
+        std::cout << "FrameExporter: could not write " << manifestPath << std::endl;
+        return false;
+    }
+    fprintf(manifest, "{\n  \"width\": %d,\n  \"height\": %d,\n  \"fps\": %.3f,\n  \"frames\": %d,\n  \"pattern\": \"frame_%%06d.png\",\n  \"files\": [",
+            m_Width, m_Height, fps, m_FramesCaptured);
+    for (int i = 0; i < m_FramesCaptured; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "frame_%06d.png", i);
+        fprintf(manifest, "%s\n    \"%s\"", i == 0 ? "" : ",", name);
+    }
+    fprintf(manifest, "\n  ]\n}\n");
+    fclose(manifest);
+
+    if (m_Failed)
+    {
+        std::cout << "FrameExporter: some frames could not be written to " << m_Directory << std::endl;
+    }
+    return !m_Failed;
+}
\ No newline at end of file
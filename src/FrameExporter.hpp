@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "AsyncReadback.hpp"
+#include "ThreadPool.hpp"
+
+// Captures every rendered frame into a numbered PNG sequence plus manifest.json.
+// Pixels come back through an AsyncReadback ring and PNG encoding runs on a pool of encoder threads,
+// so recording costs roughly one PBO copy per frame on the render thread.
+class FrameExporter
+{
+public:
+    FrameExporter(const std::string& directory, int width, int height, unsigned int numEncoders = 0, int ringSize = 3);
+    ~FrameExporter();
+
+    void CaptureFrame(); //reads the currently bound read framebuffer
+    bool Finish(double fps); //drains the ring, waits for the encoders and writes the manifest
+
+    inline int GetFramesCaptured() const { return m_FramesCaptured; }
+    inline const std::string& GetDirectory() const { return m_Directory; }
+    inline int GetWidth() const { return m_Width; }
+    inline int GetHeight() const { return m_Height; }
+
+private:
+    void Collect(bool wait);
+    std::string FramePath(long long frame) const;
+
+    std::string m_Directory;
+    int m_Width;
+    int m_Height;
+    int m_FramesCaptured;
+    bool m_Finished;
+    std::atomic<bool> m_Failed; //set by encoder threads
+    AsyncReadback m_Readback;
+    ThreadPool m_Encoders;
+};
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "FrameStats.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+FrameStats::FrameStats(int capacity)
+    : m_Capacity(capacity > 0 ? capacity : 1), m_Count(0), m_Frames(0), m_Log(nullptr), m_RowsPerFile(0),
+      m_RowsInFile(0), m_LogFileIndex(0), m_NextLogFrame(0)
+{
+    m_Cpu.assign(m_Capacity, 0.0f);
+    m_Gpu.assign(m_Capacity, 0.0f);
+}
+
+FrameStats::~FrameStats()
+{
+    StopLog();
+}
+
+long long FrameStats::AddFrame(float cpuMs)
+{
+    long long frame = m_Frames++;
+    int slot = (int)(frame % m_Capacity);
+    m_Cpu[slot] = cpuMs;
+    m_Gpu[slot] = 0.0f;
+    if (m_Count < m_Capacity)
+        m_Count++;
+
+    while (m_Log && m_NextLogFrame + s_LogLag <= frame)
+    {
+        WriteLogRow(m_NextLogFrame++);
+    }
+    return frame;
+}
+
+void FrameStats::SetGpuTime(long long frame, float gpuMs)
+{
+    if (frame < 0 || frame >= m_Frames || frame < m_Frames - m_Count)
+        return;
+    m_Gpu[frame % m_Capacity] = gpuMs;
+}
+
+FrameTimePercentiles FrameStats::ComputePercentiles(const std::vector<float>& values) const
+{
+    m_Scratch.clear();
+    for (int i = 0; i < m_Count; i++)
+    {
+        if (values[i] > 0.0f)
+            m_Scratch.push_back(values[i]);
+    }
+    FrameTimePercentiles result;
+    result.count = (int)m_Scratch.size();
+    if (m_Scratch.empty())
+        return result;
+
+    // Nearest-rank percentiles; nth_element keeps this linear in the history size
+    float* begin = &m_Scratch[0];
+    float* end = begin + m_Scratch.size();
+    float ranks[3] = { 0.50f, 0.95f, 0.99f };
+    float* outputs[3] = { &result.p50, &result.p95, &result.p99 };
+    for (int i = 0; i < 3; i++)
+    {
+        size_t rank = (size_t)(ranks[i] * (m_Scratch.size() - 1) + 0.5f);
+        std::nth_element(begin, begin + rank, end);
+        *outputs[i] = begin[rank];
+    }
+    result.max = *std::max_element(begin, end);
+    return result;
+}
+
+FrameTimePercentiles FrameStats::GetCpuPercentiles() const
+{
+    return ComputePercentiles(m_Cpu);
+}
+
+FrameTimePercentiles FrameStats::GetGpuPercentiles() const
+{
+    return ComputePercentiles(m_Gpu);
+}
+
+bool FrameStats::OpenLogFile()
+{
+    std::string path = m_LogPath;
+    if (m_LogFileIndex > 0)
+    {
+        size_t dot = path.find_last_of('.');
+        std::string suffix = "_" + std::to_string((long long)m_LogFileIndex);
+        path = dot == std::string::npos ? path + suffix : path.substr(0, dot) + suffix + path.substr(dot);
+    }
+    m_Log = fopen(path.c_str(), "w");
+    if (!m_Log)
+    {
+        std::cout << "FrameStats: could not open " << path << std::endl;
+        return false;
+    }
+    fprintf(m_Log, "frame,cpu_ms,gpu_ms\n");
+    m_RowsInFile = 0;
+    return true;
+}
+
+bool FrameStats::StartLog(const std::string& path, long long rowsPerFile)
+{
+    StopLog();
+    m_LogPath = path;
+    m_RowsPerFile = rowsPerFile;
+    m_LogFileIndex = 0;
+    m_NextLogFrame = m_Frames;
+    return OpenLogFile();
+}
+
+void FrameStats::StopLog()
+{
+    if (!m_Log)
+        return;
+    // Flush the frames still waiting for GPU times with what has arrived
+    while (m_NextLogFrame < m_Frames && m_Log)
+    {
+        WriteLogRow(m_NextLogFrame++);
+    }
+    if (m_Log)
+    {
+        fclose(m_Log);
+        m_Log = nullptr;
+    }
+}
+
+void FrameStats::WriteLogRow(long long frame)
+{
+    if (frame < m_Frames - m_Count)
+        return; //already overwritten
+    if (m_RowsPerFile > 0 && m_RowsInFile >= m_RowsPerFile)
+    {
+        fclose(m_Log);
+        m_Log = nullptr;
+        m_LogFileIndex++;
+        if (!OpenLogFile())
+            return;
+    }
+    int slot = (int)(frame % m_Capacity);
+    if (m_Gpu[slot] > 0.0f)
+        fprintf(m_Log, "%lld,%.4f,%.4f\n", frame, m_Cpu[slot], m_Gpu[slot]);
+    else
+        fprintf(m_Log, "%lld,%.4f,\n", frame, m_Cpu[slot]);
+    m_RowsInFile++;
+}
\ No newline at end of file
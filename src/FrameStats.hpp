@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct FrameTimePercentiles
+{
+    float p50 = 0.0f;
+    float p95 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+    int count = 0;
+};
+
+// Ring buffer of per-frame CPU and GPU times. GPU times arrive a few frames late (see GpuTimer) and are
+// matched to their frame by index; frames whose GPU time never arrives stay out of the GPU percentiles.
+// Optionally logs every frame to CSV, starting a new file every rowsPerFile frames.
+class FrameStats
+{
+public:
+    explicit FrameStats(int capacity = 600);
+    ~FrameStats();
+
+    long long AddFrame(float cpuMs); //returns the frame's index, counting from 0
+    inline long long GetNextFrame() const { return m_Frames; } //index the next AddFrame will return
+    void SetGpuTime(long long frame, float gpuMs);
+
+    FrameTimePercentiles GetCpuPercentiles() const;
+    FrameTimePercentiles GetGpuPercentiles() const;
+
+    // Oldest-first views for ImGui::PlotHistogram: pass GetHistoryOffset() as values_offset
+    inline const float* GetCpuHistory() const { return &m_Cpu[0]; }
+    inline const float* GetGpuHistory() const { return &m_Gpu[0]; }
+    inline int GetHistorySize() const { return m_Count; }
+    inline int GetHistoryOffset() const { return m_Count < m_Capacity ? 0 : (int)(m_Frames % m_Capacity); }
+
+    bool StartLog(const std::string& path, long long rowsPerFile = 100000);
+    void StopLog();
+    inline bool IsLogging() const { return m_Log != nullptr; }
+
+private:
+    static const int s_LogLag = 8; //frames a CSV row waits for its GPU time
+
+    FrameTimePercentiles ComputePercentiles(const std::vector<float>& values) const;
+    void WriteLogRow(long long frame);
+    bool OpenLogFile();
+
+    int m_Capacity;
+    int m_Count;
+    long long m_Frames;
+    std::vector<float> m_Cpu;
+    std::vector<float> m_Gpu; //0 until the frame's GPU time arrives
+    mutable std::vector<float> m_Scratch;
+
+    FILE* m_Log;
+    std::string m_LogPath;
+    long long m_RowsPerFile;
+    long long m_RowsInFile;
+    int m_LogFileIndex;
+    long long m_NextLogFrame;
+};
\ No newline at end of file
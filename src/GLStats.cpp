@@ -0,0 +1,47 @@
+#include "GLStats.hpp"
+
+GLCounters GLStats::s_Current;
+GLCounters GLStats::s_LastFrame;
+GLCounters GLStats::s_Completed;
+
+static void Accumulate(GLCounters& sum, const GLCounters& counters)
+{
+    sum.glCalls += counters.glCalls;
+    sum.drawCalls += counters.drawCalls;
+    sum.elementsDrawn += counters.elementsDrawn;
+    sum.programBinds += counters.programBinds;
+    sum.vaoBinds += counters.vaoBinds;
+    sum.bufferBinds += counters.bufferBinds;
+    sum.uniformSets += counters.uniformSets;
+    sum.uploads += counters.uploads;
+    sum.uploadBytes += counters.uploadBytes;
+}
+
+void GLStats::BeginFrame()
+{
+    Accumulate(s_Completed, s_Current);
+    s_LastFrame = s_Current;
+    s_Current = GLCounters();
+}
+
+GLCounters GLStats::GetTotal()
+{
+    GLCounters total = s_Completed;
+    Accumulate(total, s_Current);
+    return total;
+}
+
+GLCounters GLStats::Difference(const GLCounters& end, const GLCounters& begin)
+{
+    GLCounters difference;
+    difference.glCalls = end.glCalls - begin.glCalls;
+    difference.drawCalls = end.drawCalls - begin.drawCalls;
+    difference.elementsDrawn = end.elementsDrawn - begin.elementsDrawn;
+    difference.programBinds = end.programBinds - begin.programBinds;
+    difference.vaoBinds = end.vaoBinds - begin.vaoBinds;
+    difference.bufferBinds = end.bufferBinds - begin.bufferBinds;
+    difference.uniformSets = end.uniformSets - begin.uniformSets;
+    difference.uploads = end.uploads - begin.uploads;
+    difference.uploadBytes = end.uploadBytes - begin.uploadBytes;
+    return difference;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+// Counters bumped by the GL wrappers (Renderer, VertexArray, VertexBuffer, IndexBuffer, Shader) and the
+// draw calls in render_geom. All GL work happens on one thread, so these are plain integers.
+struct GLCounters
+{
+    unsigned long long glCalls = 0;         //calls made through GLCall
+    unsigned long long drawCalls = 0;
+    unsigned long long elementsDrawn = 0;   //vertices or indices submitted, times instances
+    unsigned long long programBinds = 0;
+    unsigned long long vaoBinds = 0;
+    unsigned long long bufferBinds = 0;
+    unsigned long long uniformSets = 0;
+    unsigned long long uploads = 0;
+    unsigned long long uploadBytes = 0;
+};
+
+class GLStats
+{
+public:
+    static inline void CountCall() { s_Current.glCalls++; }
+    static inline void CountDraw(unsigned long long elements) { s_Current.drawCalls++; s_Current.elementsDrawn += elements; }
+    static inline void CountProgramBind() { s_Current.programBinds++; }
+    static inline void CountVaoBind() { s_Current.vaoBinds++; }
+    static inline void CountBufferBind() { s_Current.bufferBinds++; }
+    static inline void CountUniform() { s_Current.uniformSets++; }
+    static inline void CountUpload(unsigned long long bytes) { s_Current.uploads++; s_Current.uploadBytes += bytes; }
+
+    // Closes the running frame; its counters become GetLastFrame()
+    static void BeginFrame();
+    static inline const GLCounters& GetLastFrame() { return s_LastFrame; }
+    // Counted since program start, including the running frame
+    static GLCounters GetTotal();
+    // Counter-wise difference, for measuring a stretch of code
+    static GLCounters Difference(const GLCounters& end, const GLCounters& begin);
+
+private:
+    static GLCounters s_Current;
+    static GLCounters s_LastFrame;
+    static GLCounters s_Completed; //sum of all closed frames
+};
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "GlobalFunctions.hpp"
+#include "Profiler.hpp"
+#include "AllocationTracker.hpp"
 #include <iostream>
 
 void ChangeStates(bool &s1, bool&s2)
@@ -40,6 +42,8 @@ void Initialize(std::vector<std::vector<std::vector<double>>>& points,
 
 std::vector<std::vector<double>> GenerateGreatCircle(float rotationX, float rotationY, float rotationZ, int n) 
 {
+    PROFILE_FUNCTION();
+    ALLOC_SCOPE("GenerateGreatCircle");
     std::vector<std::vector<double>> circlePoints;
 
     // Define the rotation matrix using GLM
@@ -65,6 +69,8 @@ std::vector<std::vector<double>> GenerateGreatCircle(float rotationX, float rota
 
 std::vector<std::vector<double>> GenerateUniform(int n)
 {
+    PROFILE_FUNCTION();
+    ALLOC_SCOPE("GenerateUniform");
 
     // Generate uniform points via golden ratio approach (O(n) rather than the usual O(n^2))
 
@@ -85,6 +91,8 @@ std::vector<std::vector<double>> GenerateUniform(int n)
 
 std::vector<std::vector<double>> GenerateRandom(int n)
 {
+    PROFILE_FUNCTION();
+    ALLOC_SCOPE("GenerateRandom");
     std::vector<std::vector<double>> points;
 
     for (int i = 0; i < n; ++i) 
@@ -99,6 +107,8 @@ std::vector<std::vector<double>> GenerateRandom(int n)
 
 std::vector<std::vector<double>> GenerateElevation(int n, double elevation)
 {
+    PROFILE_FUNCTION();
+    ALLOC_SCOPE("GenerateElevation");
     std::vector<std::vector<double>> points;
 
     // Generate a circle on sphere with elevation elevation in [-pi/2, pi/2]
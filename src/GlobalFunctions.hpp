@@ -3,7 +3,7 @@
 #include <vector>
 #include <cmath>
 
-#include "glfw/glfw3.h"
+#include "GLFW/glfw3.h"
 
 #include "Camera.hpp"
 
@@ -0,0 +1,207 @@
+#include "GpuTimer.hpp"
+
+#include <iostream>
+
+GpuTimer::GpuTimer(const std::vector<std::string>& passNames, int bufferedFrames, int historySize)
+    : m_PassNames(passNames), m_Current(0), m_OpenPass(-1), m_FrameIndex(0), m_HistorySize(historySize), m_HistoryCount(0),
+      m_HistoryHead(0), m_Log(nullptr), m_Dropped(0)
+{
+    int numPasses = (int)m_PassNames.size();
+    m_Frames.resize(bufferedFrames < 1 ? 1 : bufferedFrames);
+    for (size_t i = 0; i < m_Frames.size(); i++)
+    {
+        FrameQueries& frame = m_Frames[i];
+        frame.passQueries.resize(numPasses);
+        frame.issued.assign(numPasses, false);
+        if (numPasses > 0)
+        {
+            GLCall(glGenQueries(numPasses, &frame.passQueries[0]));
+        }
+        GLCall(glGenQueries(1, &frame.frameBegin));
+        GLCall(glGenQueries(1, &frame.frameEnd));
+        frame.frameIndex = 0;
+        frame.pending = false;
+    }
+    m_History.assign((size_t)m_HistorySize * (numPasses + 1), 0.0f);
+}
+
+GpuTimer::~GpuTimer()
+{
+    StopLog();
+}
+
+void GpuTimer::BeginFrame()
+{
+    FrameQueries& frame = m_Frames[m_Current];
+    if (frame.pending)
+    {
+        // Still unread after a full round of the ring: the GPU is that far behind, drop the sample
+        // instead of waiting for it
+        unsigned int available = 0;
+        GLCall(glGetQueryObjectuiv(frame.frameEnd, GL_QUERY_RESULT_AVAILABLE, &available));
+        if (available)
+            Collect(frame);
+        else
+            m_Dropped++;
+        frame.pending = false;
+    }
+    frame.issued.assign(m_PassNames.size(), false);
+    frame.frameIndex = m_FrameIndex++;
+    GLCall(glQueryCounter(frame.frameBegin, GL_TIMESTAMP));
+}
+
+void GpuTimer::Begin(int pass)
+{
+    ASSERT(m_OpenPass < 0); //GL_TIME_ELAPSED queries cannot nest
+    FrameQueries& frame = m_Frames[m_Current];
+    GLCall(glBeginQuery(GL_TIME_ELAPSED, frame.passQueries[pass]));
+    frame.issued[pass] = true;
+    m_OpenPass = pass;
+}
+
+void GpuTimer::End(int pass)
+{
+    ASSERT(m_OpenPass == pass);
+    GLCall(glEndQuery(GL_TIME_ELAPSED));
+    m_OpenPass = -1;
+}
+
+void GpuTimer::EndFrame()
+{
+    FrameQueries& frame = m_Frames[m_Current];
+    GLCall(glQueryCounter(frame.frameEnd, GL_TIMESTAMP));
+    frame.pending = true;
+    m_Current = (m_Current + 1) % (int)m_Frames.size();
+
+    // Oldest frame first; the end timestamp is the last query issued, so once it is available all are
+    FrameQueries& oldest = m_Frames[m_Current];
+    if (oldest.pending)
+    {
+        unsigned int available = 0;
+        GLCall(glGetQueryObjectuiv(oldest.frameEnd, GL_QUERY_RESULT_AVAILABLE, &available));
+        if (available)
+        {
+            Collect(oldest);
+            oldest.pending = false;
+        }
+    }
+}
+
+void GpuTimer::Drain()
+{
+    // m_Current is the next frame to be written, so walking the ring from it visits the oldest first
+    for (size_t i = 0; i < m_Frames.size(); i++)
+    {
+        FrameQueries& frame = m_Frames[(m_Current + i) % m_Frames.size()];
+        if (frame.pending)
+        {
+            Collect(frame); //GL_QUERY_RESULT blocks until the GPU gets there
+            frame.pending = false;
+        }
+    }
+}
+
+void GpuTimer::Collect(FrameQueries& frame)
+{
+    int numPasses = (int)m_PassNames.size();
+    float* row = &m_History[(size_t)m_HistoryHead * (numPasses + 1)];
+    for (int pass = 0; pass < numPasses; pass++)
+    {
+        GLuint64 elapsed = 0;
+        if (frame.issued[pass])
+        {
+            GLCall(glGetQueryObjectui64v(frame.passQueries[pass], GL_QUERY_RESULT, &elapsed));
+        }
+        row[pass] = elapsed / 1.0e6f;
+    }
+    GLuint64 begin = 0, end = 0;
+    GLCall(glGetQueryObjectui64v(frame.frameBegin, GL_QUERY_RESULT, &begin));
+    GLCall(glGetQueryObjectui64v(frame.frameEnd, GL_QUERY_RESULT, &end));
+    row[numPasses] = (end - begin) / 1.0e6f;
+    if (m_Collected.size() < 64)
+        m_Collected.push_back(std::make_pair(frame.frameIndex, row[numPasses]));
+
+    if (m_Log)
+    {
+        fprintf(m_Log, "%lld", frame.frameIndex);
+        for (int i = 0; i <= numPasses; i++)
+        {
+            fprintf(m_Log, ",%.4f", row[i]);
+        }
+        fprintf(m_Log, "\n");
+    }
+
+    m_HistoryHead = (m_HistoryHead + 1) % m_HistorySize;
+    if (m_HistoryCount < m_HistorySize)
+        m_HistoryCount++;
+}
+
+bool GpuTimer::PopFrameTime(long long& frame, float& ms)
+{
+    if (m_Collected.empty())
+        return false;
+    frame = m_Collected.front().first;
+    ms = m_Collected.front().second;
+    m_Collected.pop_front();
+    return true;
+}
+
+float GpuTimer::GetAverageMs(int pass) const
+{
+    if (m_HistoryCount == 0)
+        return 0.0f;
+    size_t stride = m_PassNames.size() + 1;
+    float sum = 0.0f;
+    for (int i = 0; i < m_HistoryCount; i++)
+    {
+        sum += m_History[i * stride + pass];
+    }
+    return sum / m_HistoryCount;
+}
+
+float GpuTimer::GetAverageFrameMs() const
+{
+    return GetAverageMs((int)m_PassNames.size());
+}
+
+bool GpuTimer::StartLog(const std::string& path)
+{
+    StopLog();
+    m_Log = fopen(path.c_str(), "w");
+    if (!m_Log)
+    {
+        std::cout << "GpuTimer: could not open " << path << std::endl;
+        return false;
+    }
+    fprintf(m_Log, "frame");
+    for (size_t i = 0; i < m_PassNames.size(); i++)
+    {
+        fprintf(m_Log, ",%s_ms", m_PassNames[i].c_str());
+    }
+    fprintf(m_Log, ",frame_ms\n");
+    return true;
+}
+
+void GpuTimer::StopLog()
+{
+    if (m_Log)
+    {
+        fclose(m_Log);
+        m_Log = nullptr;
+    }
+}
+
+void GpuTimer::Delete()
+{
+    for (size_t i = 0; i < m_Frames.size(); i++)
+    {
+        FrameQueries& frame = m_Frames[i];
+        if (!frame.passQueries.empty())
+        {
+            GLCall(glDeleteQueries((int)frame.passQueries.size(), &frame.passQueries[0]));
+        }
+        GLCall(glDeleteQueries(1, &frame.frameBegin));
+        GLCall(glDeleteQueries(1, &frame.frameEnd));
+    }
+    m_Frames.clear();
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Renderer.hpp"
+
+// GL_TIME_ELAPSED queries around named render passes plus GL_TIMESTAMP queries bracketing the frame.
+// Each frame writes into its own set of queries and results are read back up to bufferedFrames later, only
+// once GL_QUERY_RESULT_AVAILABLE says so, so timing never stalls the pipeline. A frame still unfinished
+// when its queries come round again is dropped and counted, so GPU-bound stretches are visible.
+class GpuTimer
+{
+public:
+    GpuTimer(const std::vector<std::string>& passNames, int bufferedFrames = 4, int historySize = 120);
+    ~GpuTimer();
+
+    void BeginFrame();
+    void Begin(int pass);   //passes may not overlap
+    void End(int pass);     //must close the pass Begin opened
+    void EndFrame();        //also collects the results of the oldest frame that has finished
+    void Drain();           //waits for every frame still in flight and collects it, oldest first
+
+    // Average over the last historySize collected frames; passes skipped in a frame count as 0
+    float GetAverageMs(int pass) const;
+    float GetAverageFrameMs() const;
+    inline const std::string& GetPassName(int pass) const { return m_PassNames[pass]; }
+    inline int GetNumPasses() const { return (int)m_PassNames.size(); }
+    // Total GPU time of frames collected since the last call, oldest first; frames count from 0 at BeginFrame
+    bool PopFrameTime(long long& frame, float& ms);
+    inline long long GetDroppedFrames() const { return m_Dropped; } //samples not ready after bufferedFrames
+
+    // Appends one row per collected frame: frame, every pass in ms, frame total in ms
+    bool StartLog(const std::string& path);
+    void StopLog();
+    inline bool IsLogging() const { return m_Log != nullptr; }
+
+    void Delete();
+
+private:
+    struct FrameQueries
+    {
+        std::vector<unsigned int> passQueries;
+        std::vector<bool> issued;
+        unsigned int frameBegin;
+        unsigned int frameEnd;
+        long long frameIndex;
+        bool pending;
+    };
+
+    void Collect(FrameQueries& frame);
+
+    std::vector<std::string> m_PassNames;
+    std::vector<FrameQueries> m_Frames;
+    int m_Current;
+    int m_OpenPass; //pass between Begin and End, -1 outside
+    long long m_FrameIndex;
+    int m_HistorySize;
+    int m_HistoryCount;
+    int m_HistoryHead;
+    std::vector<float> m_History; //historySize rows of (passes + 1) values
+    std::deque<std::pair<long long, float>> m_Collected;
+    FILE* m_Log;
+    long long m_Dropped;
+};
\ No newline at end of file
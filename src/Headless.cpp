@@ -0,0 +1,484 @@
+#include "Headless.hpp"
+
+#include <GL/glew.h>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+
+#ifdef __linux__
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include "Renderer.hpp"
+#include "Shader.hpp"
+#include "Camera.hpp"
+#include "FrameBuffer.hpp"
+#include "GlobalFunctions.hpp"
+#include "ImageWriter.hpp"
+#include "FrameExporter.hpp"
+#include "PosterRenderer.hpp"
+#include "FiberSetFile.hpp"
+#include "MeshExporter.hpp"
+#include "Scene.hpp"
+#include "Residency.hpp"
+
+HeadlessContext::HeadlessContext()
+    : m_Display(nullptr), m_Context(nullptr)
+{
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    Destroy();
+}
+
+#ifdef __linux__
+
+bool HeadlessContext::Create(int majorVersion, int minorVersion)
+{
+    EGLDisplay display = EGL_NO_DISPLAY;
+
+    // Prefer the surfaceless platform so no X11/Wayland/DRM device is ever opened
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (clientExtensions && strstr(clientExtensions, "EGL_MESA_platform_surfaceless"))
+    {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay)
+        {
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+    }
+    if (display == EGL_NO_DISPLAY)
+    {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+    {
+        std::cout << "Headless: could not initialize an EGL display" << std::endl;
+        return false;
+    }
+    m_Display = display;
+
+    const char* displayExtensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!displayExtensions || !strstr(displayExtensions, "EGL_KHR_surfaceless_context"))
+    {
+        std::cout << "Headless: EGL_KHR_surfaceless_context is not supported" << std::endl;
+        Destroy();
+        return false;
+    }
+
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint numConfigs = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &numConfigs) || numConfigs == 0)
+    {
+        std::cout << "Headless: no suitable EGL config" << std::endl;
+        Destroy();
+        return false;
+    }
+
+    eglBindAPI(EGL_OPENGL_API);
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, majorVersion,
+        EGL_CONTEXT_MINOR_VERSION, minorVersion,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (context == EGL_NO_CONTEXT)
+    {
+        std::cout << "Headless: could not create an OpenGL " << majorVersion << "." << minorVersion << " context" << std::endl;
+        Destroy();
+        return false;
+    }
+    m_Context = context;
+
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        std::cout << "Headless: eglMakeCurrent failed" << std::endl;
+        Destroy();
+        return false;
+    }
+
+    glewExperimental = GL_TRUE;
+    GLenum glewStatus = glewInit();
+    // GLX-flavoured GLEW builds report a missing X display after loading the core entry points; that is harmless here
+    if (glewStatus != GLEW_OK && glewStatus != GLEW_ERROR_NO_GLX_DISPLAY)
+    {
+        std::cout << "Headless: glewInit failed: " << glewGetErrorString(glewStatus) << std::endl;
+        Destroy();
+        return false;
+    }
+    GLClearError();
+    return true;
+}
+
+void HeadlessContext::Destroy()
+{
+    if (m_Display)
+    {
+        eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (m_Context)
+        {
+            eglDestroyContext(m_Display, m_Context);
+        }
+        eglTerminate(m_Display);
+    }
+    m_Display = nullptr;
+    m_Context = nullptr;
+}
+
+#else
+
+bool HeadlessContext::Create(int /*majorVersion*/, int /*minorVersion*/)
+{
+    std::cout << "Headless: surfaceless contexts are only supported on Linux (EGL)" << std::endl;
+    return false;
+}
+
+void HeadlessContext::Destroy()
+{
+    m_Display = nullptr;
+    m_Context = nullptr;
+}
+
+#endif
+
+static int ParseMode(const char* name)
+{
+    const char* names[] = { "greatcircle", "uniform", "random", "elevation" };
+    for (int i = 0; i < 4; i++)
+    {
+        if (strcmp(name, names[i]) == 0)
+        {
+            return i;
+        }
+    }
+    return atoi(name);
+}
+
+bool ParseHeadlessOptions(int argc, char** argv, HeadlessOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--headless")
+        {
+            continue;
+        }
+        else if (arg == "--width" && hasValue)
+        {
+            options.width = atoi(argv[++i]);
+        }
+        else if (arg == "--height" && hasValue)
+        {
+            options.height = atoi(argv[++i]);
+        }
+        else if (arg == "--mode" && hasValue)
+        {
+            options.mode = ParseMode(argv[++i]);
+        }
+        else if (arg == "--fibers" && hasValue)
+        {
+            options.numFibers = atoi(argv[++i]);
+        }
+        else if (arg == "--fov" && hasValue)
+        {
+            options.fov = (float)atof(argv[++i]);
+        }
+        else if (arg == "--frames" && hasValue)
+        {
+            options.frames = atoi(argv[++i]);
+        }
+        else if (arg == "--fps" && hasValue)
+        {
+            options.fps = (float)atof(argv[++i]);
+        }
+        else if (arg == "--encoders" && hasValue)
+        {
+            options.encoders = (unsigned int)atoi(argv[++i]);
+        }
+        else if (arg == "--tiled")
+        {
+            options.tiled = true;
+        }
+        else if (arg == "--tile-size" && hasValue)
+        {
+            options.tileSize = atoi(argv[++i]);
+        }
+        else if (arg == "--load" && hasValue)
+        {
+            options.load = argv[++i];
+        }
+        else if (arg == "--save" && hasValue)
+        {
+            options.save = argv[++i];
+        }
+        else if (arg == "--quantize")
+        {
+            options.quantize = true;
+        }
+        else if (arg == "--gpu-resident")
+        {
+            options.gpuResident = true;
+        }
+        else if (arg == "--vertex-format" && hasValue)
+        {
+            std::string format = argv[++i];
+            if (!ParseVertexFormat(format, options.vertexFormat))
+            {
+                std::cout << "Unknown vertex format: " << format << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--export" && hasValue)
+        {
+            options.exportPath = argv[++i];
+        }
+        else if (arg == "--export-geometry" && hasValue)
+        {
+            std::string geometry = argv[++i];
+            if (geometry != "fibers" && geometry != "tubes" && geometry != "surface")
+            {
+                std::cout << "Unknown export geometry: " << geometry << std::endl;
+                return false;
+            }
+            options.exportGeometry = geometry == "tubes" ? 1 : geometry == "surface" ? 2 : 0;
+        }
+        else if (arg == "--output" && hasValue)
+        {
+            options.output = argv[++i];
+        }
+        else if (arg == "--ground")
+        {
+            options.drawGround = true;
+        }
+        else if (arg == "--no-axis")
+        {
+            options.drawCoordinateAxis = false;
+        }
+        else
+        {
+            std::cout << "Unknown headless option: " << arg << std::endl;
+            std::cout << "Usage: main --headless [--width W] [--height H] [--mode greatcircle|uniform|random|elevation]"
+                         " [--fibers N] [--fov degrees] [--ground] [--no-axis] [--output file.png|file.ppm]" << std::endl;
+            std::cout << "       main --headless --width 32768 --height 16384 [--tiled] [--tile-size S] --output poster.png ..." << std::endl;
+            std::cout << "       main --headless [--load set.hfs] [--save set.hfs [--quantize]] [--gpu-resident] [--vertex-format float|half|snorm16] ..." << std::endl;
+            std::cout << "       main --headless --export mesh.ply|mesh.obj|mesh.gltf [--export-geometry fibers|tubes|surface] ..." << std::endl;
+            std::cout << "       main --headless --frames N [--fps F] [--encoders T] --output directory ..." << std::endl;
+            return false;
+        }
+    }
+    if (options.frames > 0 && !options.load.empty())
+    {
+        std::cout << "--frames animates generated base points and cannot be combined with --load" << std::endl;
+        return false;
+    }
+    if (options.width <= 0 || options.height <= 0 || options.numFibers <= 0 || options.mode < 0 || options.mode > 3 || options.frames < 0)
+    {
+        std::cout << "Invalid headless options" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Rotates the base points about the x axis, the same motion as dragging the X Rotation slider
+static void RotateBasePoints(const std::vector<std::vector<double>>& source, double angle, std::vector<std::vector<double>>& target)
+{
+    double c = cos(angle);
+    double s = sin(angle);
+    target.resize(source.size());
+    for (size_t i = 0; i < source.size(); i++)
+    {
+        double y = source[i][1];
+        double z = source[i][2];
+        target[i] = { source[i][0], c * y - s * z, s * y + c * z };
+    }
+}
+
+int RunHeadless(const HeadlessOptions& options)
+{
+    srand(1); //Random mode must produce the same image on every run
+    std::vector<std::vector<std::vector<double>>> points;
+    Initialize(points, options.mode, options.numFibers);
+    return RunHeadless(options, points[0]);
+}
+
+// Fibers at the default step go through Hopf's own path; other steps are built as a FiberSet first
+static Hopf CreateHopf(const HeadlessOptions& options, std::vector<std::vector<double>>& basePoints)
+{
+    if (options.phiInc == FIBER_PHI_STEP && options.precision == FiberPrecision::Double)
+    {
+        return Hopf(&basePoints, false, 5.0f, options.vertexFormat);
+    }
+    FiberSet fiberSet;
+    BuildFiberSet(basePoints, fiberSet, options.phiInc, options.precision);
+    return Hopf(fiberSet.GetView(), false, 5.0f, options.vertexFormat);
+}
+
+int RunHeadless(const HeadlessOptions& options, std::vector<std::vector<double>>& basePoints)
+{
+    if (!options.exportPath.empty())
+    {
+        // Export needs no GL context; fibers are generated and written in chunks
+        ExportOptions exportOptions;
+        exportOptions.geometry = (ExportGeometry)options.exportGeometry;
+        exportOptions.phiInc = options.phiInc;
+        exportOptions.precision = options.precision;
+        exportOptions.closeSurface = options.mode == 0 || options.mode == 3; //great and elevation circles are closed curves
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (!ExportFibers(basePoints, options.exportPath, exportOptions))
+        {
+            return -1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Exported " << basePoints.size() << " fibers to " << options.exportPath << " in " << seconds << "s" << std::endl;
+        return 0;
+    }
+
+    HeadlessContext context;
+    if (!context.Create(4, 1)) //the shaders are #version 410 core
+    {
+        return -1;
+    }
+    Residency::SetGpuResident(options.gpuResident);
+    std::cout << glGetString(GL_VERSION) << " (" << glGetString(GL_RENDERER) << ")" << std::endl;
+
+    {
+        Renderer renderer;
+        Shader shader("res/shaders/Basic.shader");
+        Shader fiberShader("res/shaders/Fiber.shader");
+
+        std::vector<Hopf> hopfs;
+        MappedFiberSet mapped; //kept open so --save can write the loaded set
+        if (!options.load.empty())
+        {
+            if (!mapped.Open(options.load))
+            {
+                return -1;
+            }
+            hopfs.push_back(Hopf(mapped.GetRawView(), false, 5.0f, options.vertexFormat));
+        }
+        else
+        {
+            hopfs.push_back(CreateHopf(options, basePoints));
+        }
+        if (!options.save.empty())
+        {
+            FiberSet fiberSet;
+            FiberSetView view;
+            if (!options.load.empty())
+            {
+                view = mapped.GetView(); //the loaded set, expanded to float if it was quantized
+            }
+            else
+            {
+                BuildFiberSet(basePoints, fiberSet, options.phiInc, options.precision);
+                view = fiberSet.GetView();
+            }
+            if (!SaveFiberSet(options.save, view, options.quantize))
+            {
+                return -1;
+            }
+            std::cout << "Saved " << view.numFibers << " fibers to " << options.save << std::endl;
+        }
+
+        Axis axis(10000.0f);
+        Plane plane(10000.0f, 10000.0f);
+
+        Camera camera(options.fov, (float)options.width / (float)options.height, 0.1f, 50000.0f, nullptr, false);
+        camera.SetPosition(glm::vec3(0, 50.0f, 0.0));
+
+        SceneOptions sceneOptions;
+        sceneOptions.drawGround = options.drawGround;
+        sceneOptions.drawCoordinateAxis = options.drawCoordinateAxis;
+
+        int maxTileSize = GetMaxTileSize();
+        if (options.tiled || options.width > maxTileSize || options.height > maxTileSize)
+        {
+            if (options.frames > 0)
+            {
+                std::cout << "Tiled rendering only supports single images" << std::endl;
+                return -1;
+            }
+            ConfigureRenderState(options.width, options.height);
+            PosterOptions posterOptions;
+            posterOptions.width = options.width;
+            posterOptions.height = options.height;
+            posterOptions.tileSize = options.tileSize;
+            posterOptions.output = options.output;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            bool written = RenderPoster(posterOptions, camera, [&](const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix) {
+                DrawScene(renderer, shader, fiberShader, axis, plane, hopfs, viewMatrix, projectionMatrix, sceneOptions);
+            });
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (!written)
+            {
+                return -1;
+            }
+            std::cout << "Wrote tiled " << options.output << " (" << options.width << "x" << options.height << ") in " << seconds << "s" << std::endl;
+            return 0;
+        }
+
+        FrameBuffer fbo;
+        fbo.AttachTexture(options.width, options.height);
+        fbo.AttachDepthBuffer();
+
+        fbo.Bind();
+        ConfigureRenderState(options.width, options.height);
+
+        if (options.frames > 0)
+        {
+            FrameExporter exporter(options.output, options.width, options.height, options.encoders);
+            std::vector<std::vector<double>> initialPoints = basePoints;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (int frame = 0; frame < options.frames; frame++)
+            {
+                RotateBasePoints(initialPoints, 2 * PI * frame / options.frames, basePoints);
+                if (options.phiInc == FIBER_PHI_STEP && options.precision == FiberPrecision::Double)
+                    hopfs[0].UpdateCircles(&basePoints);
+                else
+                    hopfs[0] = CreateHopf(options, basePoints);
+                DrawScene(renderer, shader, fiberShader, axis, plane, hopfs, camera.GetViewMatrix(), camera.GetProjectionMatrix(), sceneOptions);
+                exporter.CaptureFrame();
+            }
+            bool written = exporter.Finish(options.fps);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            fbo.Unbind();
+            fbo.Delete();
+            std::cout << "Exported " << exporter.GetFramesCaptured() << " frames to " << options.output << " in " << seconds
+                      << "s (" << exporter.GetFramesCaptured() / seconds << " frames/s)" << std::endl;
+            return written ? 0 : -1;
+        }
+
+        DrawScene(renderer, shader, fiberShader, axis, plane, hopfs, camera.GetViewMatrix(), camera.GetProjectionMatrix(), sceneOptions);
+        GLCall(glFinish());
+
+        std::vector<unsigned char> pixels;
+        fbo.ReadPixels(pixels);
+        fbo.Unbind();
+        fbo.Delete();
+
+        if (!WriteImage(options.output, options.width, options.height, 3, &pixels[0], true))
+        {
+            return -1;
+        }
+        std::cout << "Wrote " << options.output << " (" << options.width << "x" << options.height << ")" << std::endl;
+    }
+    return 0;
+}
\ No newline at end of file
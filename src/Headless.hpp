@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "FiberSet.hpp"
+#include "VertexFormat.hpp"
+
+// Owns an OpenGL context that is not tied to any window or display server.
+// On Linux this is a surfaceless EGL context (Mesa's EGL_MESA_platform_surfaceless when available),
+// so all rendering has to go into a FrameBuffer.
+class HeadlessContext
+{
+public:
+    HeadlessContext();
+    ~HeadlessContext();
+
+    bool Create(int majorVersion, int minorVersion);
+    void Destroy();
+    bool IsValid() const { return m_Context != nullptr; }
+
+private:
+    void* m_Display;
+    void* m_Context;
+};
+
+struct HeadlessOptions
+{
+    int width = 1920;
+    int height = 1080;
+    int mode = 0;           //same indices as the Mode combo: Great Circle, Uniform, Random, Elevation
+    int numFibers = 100;
+    float fov = 45.0f;
+    bool drawGround = false;
+    bool drawCoordinateAxis = true;
+    int frames = 0;         //> 0 exports an animation into the output directory instead of a single image
+    float fps = 30.0f;
+    unsigned int encoders = 0; //PNG encoder threads, 0 = one per hardware thread
+    bool tiled = false;     //forced on when the image exceeds GL_MAX_TEXTURE_SIZE
+    int tileSize = 0;       //0 = PosterRenderer default
+    std::string load;       //render a saved .hfs fiber set instead of generating one
+    std::string save;       //also write the generated fiber set here
+    bool quantize = false;
+    std::string exportPath; //stream the generated geometry to .ply/.obj/.gltf instead of rendering
+    int exportGeometry = 0; //ExportGeometry: fibers, tubes, surface
+    double phiInc = FIBER_PHI_STEP; //sampling step along each fiber
+    FiberPrecision precision = FiberPrecision::Double;
+    bool gpuResident = false; //free CPU copies of geometry once uploaded
+    VertexFormat vertexFormat = VertexFormat::Float32; //fiber positions on the GPU
+    std::string output = "hopf.png";
+};
+
+bool ParseHeadlessOptions(int argc, char** argv, HeadlessOptions& options);
+int RunHeadless(const HeadlessOptions& options);
+// Renders or exports the given base points instead of generating them from options.mode
+int RunHeadless(const HeadlessOptions& options, std::vector<std::vector<double>>& basePoints);
\ No newline at end of file
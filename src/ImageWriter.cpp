@@ -0,0 +1,256 @@
+#include "ImageWriter.hpp"
+#include <iostream>
+
+static const size_t maxStoredBlock = 65535;
+
+struct Crc32Table
+{
+    unsigned int entries[256];
+
+    Crc32Table()
+    {
+        for (unsigned int n = 0; n < 256; n++)
+        {
+            unsigned int c = n;
+            for (int k = 0; k < 8; k++)
+            {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[n] = c;
+        }
+    }
+};
+
+static unsigned int Crc32(unsigned int crc, const unsigned char* data, size_t size)
+{
+    // Encoder threads share the table; a function-local static is built exactly once (C++11)
+    static const Crc32Table table;
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static unsigned int Adler32(unsigned int adler, const unsigned char* data, size_t size)
+{
+    unsigned int a = adler & 0xFFFF;
+    unsigned int b = adler >> 16;
+    while (size > 0)
+    {
+        size_t n = size < 5552 ? size : 5552; //largest n that cannot overflow 32 bits before the modulo
+        size -= n;
+        while (n--)
+        {
+            a += *data++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+static void PutBigEndian(unsigned char* out, unsigned int value)
+{
+    out[0] = (unsigned char)(value >> 24);
+    out[1] = (unsigned char)(value >> 16);
+    out[2] = (unsigned char)(value >> 8);
+    out[3] = (unsigned char)value;
+}
+
+static bool EndsWith(const std::string& s, const std::string& suffix)
+{
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+ImageWriter::ImageWriter()
+    : m_File(nullptr), m_Png(true), m_Width(0), m_Height(0), m_Channels(0), m_RowsWritten(0), m_Adler(1), m_StreamStarted(false)
+{
+}
+
+ImageWriter::~ImageWriter()
+{
+    if (m_File)
+    {
+        Close();
+    }
+}
+
+bool ImageWriter::Open(const std::string& path, int width, int height, int channels)
+{
+    m_Png = !EndsWith(path, ".ppm");
+    if ((channels != 3 && channels != 4) || (!m_Png && channels != 3))
+    {
+        std::cout << "ImageWriter: unsupported channel count " << channels << " for " << path << std::endl;
+        return false;
+    }
+    m_File = fopen(path.c_str(), "wb");
+    if (!m_File)
+    {
+        std::cout << "ImageWriter: could not open " << path << std::endl;
+        return false;
+    }
+    setvbuf(m_File, nullptr, _IOFBF, 1 << 20);
+    m_Width = width;
+    m_Height = height;
+    m_Channels = channels;
+    m_RowsWritten = 0;
+    m_Adler = 1;
+    m_StreamStarted = false;
+    m_Pending.clear();
+
+    if (!m_Png)
+    {
+        fprintf(m_File, "P6\n%d %d\n255\n", width, height);
+        return true;
+    }
+
+    static const unsigned char signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    fwrite(signature, 1, 8, m_File);
+
+    unsigned char header[13];
+    PutBigEndian(header, (unsigned int)width);
+    PutBigEndian(header + 4, (unsigned int)height);
+    header[8] = 8;                          //bit depth
+    header[9] = channels == 4 ? 6 : 2;      //color type: RGBA or RGB
+    header[10] = 0;                         //deflate
+    header[11] = 0;                         //adaptive filtering, every row uses filter 0
+    header[12] = 0;                         //no interlace
+    WriteChunk("IHDR", header, sizeof(header));
+    return true;
+}
+
+bool ImageWriter::WriteRows(const unsigned char* rows, int numRows)
+{
+    if (!m_File || m_RowsWritten + numRows > m_Height)
+    {
+        return false;
+    }
+    size_t rowSize = (size_t)m_Width * m_Channels;
+    if (!m_Png)
+    {
+        fwrite(rows, rowSize, numRows, m_File);
+        m_RowsWritten += numRows;
+        return true;
+    }
+
+    for (int i = 0; i < numRows; i++)
+    {
+        const unsigned char filter = 0;
+        const unsigned char* row = rows + i * rowSize;
+        m_Adler = Adler32(m_Adler, &filter, 1);
+        m_Adler = Adler32(m_Adler, row, rowSize);
+        m_Pending.push_back(filter);
+        m_Pending.insert(m_Pending.end(), row, row + rowSize);
+    }
+    m_RowsWritten += numRows;
+    FlushBlocks(false);
+    return true;
+}
+
+bool ImageWriter::Close()
+{
+    if (!m_File)
+    {
+        return false;
+    }
+    bool complete = m_RowsWritten == m_Height;
+    if (m_Png)
+    {
+        FlushBlocks(true);
+        WriteChunk("IEND", nullptr, 0);
+    }
+    bool ok = ferror(m_File) == 0;
+    fclose(m_File);
+    m_File = nullptr;
+    if (!complete)
+    {
+        std::cout << "ImageWriter: image closed after " << m_RowsWritten << " of " << m_Height << " rows" << std::endl;
+    }
+    return ok && complete;
+}
+
+void ImageWriter::FlushBlocks(bool final)
+{
+    m_Chunk.clear();
+    if (!m_StreamStarted)
+    {
+        m_Chunk.push_back(0x78); //zlib header: deflate, 32K window, no preset dictionary
+        m_Chunk.push_back(0x01);
+        m_StreamStarted = true;
+    }
+
+    size_t offset = 0;
+    while (m_Pending.size() - offset >= maxStoredBlock || final)
+    {
+        size_t length = m_Pending.size() - offset < maxStoredBlock ? m_Pending.size() - offset : maxStoredBlock;
+        bool last = final && offset + length == m_Pending.size();
+        m_Chunk.push_back(last ? 1 : 0); //BFINAL bit, BTYPE = 00 (stored)
+        m_Chunk.push_back((unsigned char)(length & 0xFF));
+        m_Chunk.push_back((unsigned char)(length >> 8));
+        m_Chunk.push_back((unsigned char)(~length & 0xFF));
+        m_Chunk.push_back((unsigned char)((~length >> 8) & 0xFF));
+        m_Chunk.insert(m_Chunk.end(), m_Pending.begin() + offset, m_Pending.begin() + offset + length);
+        offset += length;
+        if (last)
+        {
+            break;
+        }
+    }
+    m_Pending.erase(m_Pending.begin(), m_Pending.begin() + offset);
+
+    if (final)
+    {
+        unsigned char trailer[4];
+        PutBigEndian(trailer, m_Adler);
+        m_Chunk.insert(m_Chunk.end(), trailer, trailer + 4);
+    }
+    if (!m_Chunk.empty())
+    {
+        WriteChunk("IDAT", &m_Chunk[0], m_Chunk.size());
+    }
+}
+
+void ImageWriter::WriteChunk(const char* type, const unsigned char* data, size_t size)
+{
+    unsigned char header[8];
+    PutBigEndian(header, (unsigned int)size);
+    header[4] = type[0];
+    header[5] = type[1];
+    header[6] = type[2];
+    header[7] = type[3];
+    fwrite(header, 1, 8, m_File);
+    if (size > 0)
+    {
+        fwrite(data, 1, size, m_File);
+    }
+    unsigned int crc = Crc32(0, header + 4, 4);
+    crc = Crc32(crc, data, size);
+    unsigned char footer[4];
+    PutBigEndian(footer, crc);
+    fwrite(footer, 1, 4, m_File);
+}
+
+bool WriteImage(const std::string& path, int width, int height, int channels, const unsigned char* pixels, bool flipVertically)
+{
+    ImageWriter writer;
+    if (!writer.Open(path, width, height, channels))
+    {
+        return false;
+    }
+    size_t rowSize = (size_t)width * channels;
+    if (flipVertically)
+    {
+        for (int y = height - 1; y >= 0; y--)
+        {
+            writer.WriteRows(pixels + y * rowSize, 1);
+        }
+    }
+    else
+    {
+        writer.WriteRows(pixels, height);
+    }
+    return writer.Close();
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Streams an 8-bit RGB/RGBA image to disk row by row so callers never need the whole image in memory.
+// PNG output uses stored (uncompressed) deflate blocks, which keeps the writer dependency free and lets
+// every IDAT chunk be emitted as soon as its rows arrive.
+class ImageWriter
+{
+public:
+    ImageWriter();
+    ~ImageWriter();
+
+    bool Open(const std::string& path, int width, int height, int channels);
+    bool WriteRows(const unsigned char* rows, int numRows); //rows are tightly packed, top to bottom
+    bool Close();
+
+    inline int GetWidth() const { return m_Width; }
+    inline int GetHeight() const { return m_Height; }
+
+private:
+    void WriteChunk(const char* type, const unsigned char* data, size_t size);
+    void FlushBlocks(bool final);
+
+    FILE* m_File;
+    bool m_Png;
+    int m_Width;
+    int m_Height;
+    int m_Channels;
+    int m_RowsWritten;
+    unsigned int m_Adler;
+    bool m_StreamStarted;
+    std::vector<unsigned char> m_Pending; //scanlines waiting to be packed into stored blocks
+    std::vector<unsigned char> m_Chunk;
+};
+
+// Writes a whole image; glReadPixels output is bottom to top, so pass flipVertically = true for it
+bool WriteImage(const std::string& path, int width, int height, int channels, const unsigned char* pixels, bool flipVertically);
\ No newline at end of file
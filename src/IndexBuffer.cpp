@@ -1,24 +1,77 @@
 #include "IndexBuffer.hpp"
 #include "Renderer.hpp"
+#include "Profiler.hpp"
+#include "GLStats.hpp"
 #include <iostream>
 
 IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
 	: m_Count(count)
 {
+    PROFILE_SCOPE("IndexBuffer upload");
     ASSERT(sizeof(unsigned int) == sizeof(GLuint)); //make sure the size of the data is the same as the size of the buffer
     GLCall(glGenBuffers(1, &m_RendererID));   //generate 1 buffer, store it in buffer
     GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));  //GL_ARRAY_BUFFER is a type of buffer, bind the current buffer
     GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW)); //6 * sizeof(float) is the size of the data we are storing
+    GLStats::CountUpload(count * sizeof(unsigned int));
+}
+
+IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count, BufferArena& arena)
+	: m_Count(count), m_Arena(&arena)
+{
+    PROFILE_SCOPE("IndexBuffer upload");
+    m_Range = arena.Allocate(count * sizeof(unsigned int));
+    m_RendererID = m_Range.buffer;
+    arena.Upload(m_Range, data, count * sizeof(unsigned int));
 }
 
-/*
 IndexBuffer::~IndexBuffer()
 {
-    GLCall(glDeleteBuffers(1, &m_RendererID));	//delete the buffer
-}*/
+    Delete();
+}
+
+IndexBuffer::IndexBuffer(IndexBuffer&& other) noexcept
+    : m_RendererID(other.m_RendererID), m_Count(other.m_Count), m_Range(other.m_Range), m_Arena(other.m_Arena)
+{
+    other.m_RendererID = 0;
+    other.m_Count = 0;
+    other.m_Range = BufferRange();
+    other.m_Arena = nullptr;
+}
+
+IndexBuffer& IndexBuffer::operator=(IndexBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        Delete();
+        m_RendererID = other.m_RendererID;
+        m_Count = other.m_Count;
+        m_Range = other.m_Range;
+        m_Arena = other.m_Arena;
+        other.m_RendererID = 0;
+        other.m_Count = 0;
+        other.m_Range = BufferRange();
+        other.m_Arena = nullptr;
+    }
+    return *this;
+}
+
+void IndexBuffer::Delete()
+{
+    if (m_Arena)
+    {
+        m_Arena->Free(m_Range);
+        m_RendererID = 0;
+    }
+    else if (m_RendererID)
+    {
+        GLCall(glDeleteBuffers(1, &m_RendererID));	//delete the buffer
+        m_RendererID = 0;
+    }
+}
 
 void IndexBuffer::Bind() const
 {
+    GLStats::CountBufferBind();
     GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));  //GL_ARRAY_BUFFER is a type of buffer, bind the current buffer
 }
 void IndexBuffer::Unbind() const
@@ -1,16 +1,32 @@
 #pragma once
 
+#include <cstddef>
+
+#include "BufferArena.hpp"
+
+// Owns its GL buffer, or a range of a BufferArena block: move-only, released in the destructor
 class IndexBuffer
 {
 public:
-	IndexBuffer() : m_RendererID(0) {}; //default constructor
+	IndexBuffer() : m_RendererID(0), m_Count(0) {}; //default constructor
 	IndexBuffer(const unsigned int* data, unsigned int count); //constructor
+	IndexBuffer(const unsigned int* data, unsigned int count, BufferArena& arena); //range of a shared arena block
+	~IndexBuffer();
+	IndexBuffer(IndexBuffer&& other) noexcept;
+	IndexBuffer& operator=(IndexBuffer&& other) noexcept;
+	IndexBuffer(const IndexBuffer&) = delete;
+	IndexBuffer& operator=(const IndexBuffer&) = delete;
 
 	void Bind() const;
 	void Unbind() const;
+	void Delete(); //releases the buffer early; safe to call more than once
 
 	inline unsigned int GetCount() const { return m_Count; }
+	// The indices argument for glDrawElements: the byte offset of the data in the bound buffer
+	inline const void* GetIndices() const { return (const void*)(std::size_t)m_Range.offset; }
 private:
 	unsigned int m_RendererID = 0;
-	unsigned int m_Count;
+	unsigned int m_Count = 0;
+	BufferRange m_Range;            //block >= 0 when the data lives in an arena
+	BufferArena* m_Arena = nullptr;
 };
\ No newline at end of file
@@ -0,0 +1,467 @@
+#include "MeshExporter.hpp"
+#include "GlobalFunctions.hpp"
+#include "RingIndices.hpp"
+#include "Profiler.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+static bool EndsWith(const std::string& s, const std::string& suffix)
+{
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// PLY
+
+bool PlyWriter::Begin(const std::string& path, uint64_t numVertices, uint64_t numPrimitives, int verticesPerPrimitive)
+{
+    m_VerticesPerPrimitive = verticesPerPrimitive;
+    if (!m_File.Open(path))
+    {
+        return false;
+    }
+    char primitiveElement[128];
+    if (verticesPerPrimitive == 2)
+        snprintf(primitiveElement, sizeof(primitiveElement), "element edge %llu\nproperty int vertex1\nproperty int vertex2\n", (unsigned long long)numPrimitives);
+    else
+        snprintf(primitiveElement, sizeof(primitiveElement), "element face %llu\nproperty list uchar int vertex_indices\n", (unsigned long long)numPrimitives);
+
+    char header[1024];
+    int headerSize = snprintf(header, sizeof(header),
+        "ply\n"
+        "format binary_little_endian 1.0\n"
+        "comment Hopf fibration export\n"
+        "element vertex %llu\n"
+        "property float x\n"
+        "property float y\n"
+        "property float z\n"
+        "property uchar red\n"
+        "property uchar green\n"
+        "property uchar blue\n"
+        "%s"
+        "end_header\n",
+        (unsigned long long)numVertices, primitiveElement);
+    m_File.WriteAt(0, header, headerSize);
+
+    uint64_t vertexSize = 3 * sizeof(float) + 3;
+    m_Vertices.reset(new RegionWriter(m_File, headerSize));
+    m_Primitives.reset(new RegionWriter(m_File, headerSize + numVertices * vertexSize));
+    return true;
+}
+
+void PlyWriter::WriteVertices(const float* positions, const unsigned char* colors, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        m_Vertices->Write(positions + i * 3, 3 * sizeof(float));
+        m_Vertices->Write(colors + i * 4, 3);
+    }
+}
+
+void PlyWriter::WritePrimitives(const uint32_t* indices, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (m_VerticesPerPrimitive != 2)
+        {
+            unsigned char listSize = (unsigned char)m_VerticesPerPrimitive;
+            m_Primitives->Write(&listSize, 1);
+        }
+        m_Primitives->Write(indices + i * m_VerticesPerPrimitive, m_VerticesPerPrimitive * sizeof(uint32_t));
+    }
+}
+
+bool PlyWriter::End()
+{
+    m_Vertices.reset();
+    m_Primitives.reset();
+    return m_File.Close();
+}
+
+// OBJ
+
+bool ObjWriter::Begin(const std::string& path, uint64_t numVertices, uint64_t numPrimitives, int verticesPerPrimitive)
+{
+    m_VerticesPerPrimitive = verticesPerPrimitive;
+    if (!m_File.Open(path))
+    {
+        return false;
+    }
+    m_Output.reset(new RegionWriter(m_File, 0));
+    char header[256];
+    int size = snprintf(header, sizeof(header), "# Hopf fibration export\n# %llu vertices, %llu %s\n",
+        (unsigned long long)numVertices, (unsigned long long)numPrimitives, verticesPerPrimitive == 2 ? "segments" : "triangles");
+    m_Output->Write(header, size);
+    return true;
+}
+
+void ObjWriter::WriteVertices(const float* positions, const unsigned char* colors, size_t count)
+{
+    char line[128];
+    for (size_t i = 0; i < count; i++)
+    {
+        const float* p = positions + i * 3;
+        const unsigned char* c = colors + i * 4;
+        int size = snprintf(line, sizeof(line), "v %.6g %.6g %.6g %.4g %.4g %.4g\n",
+            p[0], p[1], p[2], c[0] / 255.0, c[1] / 255.0, c[2] / 255.0);
+        m_Output->Write(line, size);
+    }
+}
+
+void ObjWriter::WritePrimitives(const uint32_t* indices, size_t count)
+{
+    char line[128];
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint32_t* v = indices + i * m_VerticesPerPrimitive;
+        int size = m_VerticesPerPrimitive == 2
+            ? snprintf(line, sizeof(line), "l %u %u\n", v[0] + 1, v[1] + 1)
+            : snprintf(line, sizeof(line), "f %u %u %u\n", v[0] + 1, v[1] + 1, v[2] + 1);
+        m_Output->Write(line, size);
+    }
+}
+
+bool ObjWriter::End()
+{
+    m_Output.reset();
+    return m_File.Close();
+}
+
+// glTF
+
+bool GltfWriter::Begin(const std::string& path, uint64_t numVertices, uint64_t numPrimitives, int verticesPerPrimitive)
+{
+    m_Path = path;
+    m_NumVertices = numVertices;
+    m_NumPrimitives = numPrimitives;
+    m_VerticesPerPrimitive = verticesPerPrimitive;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        m_Min[axis] = INFINITY;
+        m_Max[axis] = -INFINITY;
+    }
+
+    std::string binaryPath = path.substr(0, path.size() - 5) + ".bin";
+    size_t slash = binaryPath.find_last_of("/\\");
+    m_BinaryName = slash == std::string::npos ? binaryPath : binaryPath.substr(slash + 1);
+    if (!m_File.Open(binaryPath))
+    {
+        return false;
+    }
+    m_Positions.reset(new RegionWriter(m_File, 0));
+    m_Colors.reset(new RegionWriter(m_File, numVertices * 12));
+    m_Indices.reset(new RegionWriter(m_File, numVertices * 16));
+    return true;
+}
+
+void GltfWriter::WriteVertices(const float* positions, const unsigned char* colors, size_t count)
+{
+    for (size_t i = 0; i < count * 3; i++)
+    {
+        int axis = i % 3;
+        m_Min[axis] = positions[i] < m_Min[axis] ? positions[i] : m_Min[axis];
+        m_Max[axis] = positions[i] > m_Max[axis] ? positions[i] : m_Max[axis];
+    }
+    m_Positions->Write(positions, count * 3 * sizeof(float));
+    m_Colors->Write(colors, count * 4);
+}
+
+void GltfWriter::WritePrimitives(const uint32_t* indices, size_t count)
+{
+    m_Indices->Write(indices, count * m_VerticesPerPrimitive * sizeof(uint32_t));
+}
+
+bool GltfWriter::End()
+{
+    m_Positions.reset();
+    m_Colors.reset();
+    m_Indices.reset();
+    bool ok = m_File.Close();
+
+    FILE* document = fopen(m_Path.c_str(), "w");
+    if (!document)
+    {
+        std::cout << "GltfWriter: could not open " << m_Path << std::endl;
+        return false;
+    }
+    unsigned long long numVertices = m_NumVertices;
+    unsigned long long numIndices = m_NumPrimitives * m_VerticesPerPrimitive;
+    if (numVertices == 0)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            m_Min[axis] = m_Max[axis] = 0.0f;
+        }
+    }
+    fprintf(document,
+        "{\n"
+        "  \"asset\": { \"version\": \"2.0\", \"generator\": \"Hopf Fibration\" },\n"
+        "  \"scene\": 0,\n"
+        "  \"scenes\": [ { \"nodes\": [ 0 ] } ],\n"
+        "  \"nodes\": [ { \"mesh\": 0 } ],\n"
+        "  \"meshes\": [ { \"primitives\": [ { \"attributes\": { \"POSITION\": 0, \"COLOR_0\": 1 }, \"indices\": 2, \"mode\": %d } ] } ],\n"
+        "  \"buffers\": [ { \"uri\": \"%s\", \"byteLength\": %llu } ],\n"
+        "  \"bufferViews\": [\n"
+        "    { \"buffer\": 0, \"byteOffset\": 0, \"byteLength\": %llu, \"target\": 34962 },\n"
+        "    { \"buffer\": 0, \"byteOffset\": %llu, \"byteLength\": %llu, \"target\": 34962 },\n"
+        "    { \"buffer\": 0, \"byteOffset\": %llu, \"byteLength\": %llu, \"target\": 34963 }\n"
+        "  ],\n"
+        "  \"accessors\": [\n"
+        "    { \"bufferView\": 0, \"componentType\": 5126, \"count\": %llu, \"type\": \"VEC3\", \"min\": [ %.9g, %.9g, %.9g ], \"max\": [ %.9g, %.9g, %.9g ] },\n"
+        "    { \"bufferView\": 1, \"componentType\": 5121, \"normalized\": true, \"count\": %llu, \"type\": \"VEC4\" },\n"
+        "    { \"bufferView\": 2, \"componentType\": 5125, \"count\": %llu, \"type\": \"SCALAR\" }\n"
+        "  ]\n"
+        "}\n",
+        m_VerticesPerPrimitive == 2 ? 1 : 4, //LINES or TRIANGLES
+        m_BinaryName.c_str(), numVertices * 16 + numIndices * 4,
+        numVertices * 12,
+        numVertices * 12, numVertices * 4,
+        numVertices * 16, numIndices * 4,
+        numVertices, m_Min[0], m_Min[1], m_Min[2], m_Max[0], m_Max[1], m_Max[2],
+        numVertices,
+        numIndices);
+    ok = ferror(document) == 0 && ok;
+    ok = fclose(document) == 0 && ok;
+    return ok;
+}
+
+std::unique_ptr<MeshWriter> CreateMeshWriter(const std::string& path)
+{
+    if (EndsWith(path, ".ply"))
+        return std::unique_ptr<MeshWriter>(new PlyWriter());
+    if (EndsWith(path, ".obj"))
+        return std::unique_ptr<MeshWriter>(new ObjWriter());
+    if (EndsWith(path, ".gltf"))
+        return std::unique_ptr<MeshWriter>(new GltfWriter());
+    return std::unique_ptr<MeshWriter>();
+}
+
+// Appends the ring of tube vertices around every sample of one fiber
+static void GenerateTube(const float* vertices, unsigned int samples, float radius, int sides, std::vector<float>& positions)
+{
+    for (unsigned int j = 0; j < samples; j++)
+    {
+        const float* p = vertices + j * 3;
+        const float* prev = vertices + ((j + samples - 1) % samples) * 3;
+        const float* next = vertices + ((j + 1) % samples) * 3;
+
+        double t[3], n[3], b[3];
+        for (int a = 0; a < 3; a++)
+        {
+            t[a] = next[a] - prev[a];
+            n[a] = next[a] + prev[a] - 2.0 * p[a]; //discrete curvature, points at the circle center
+        }
+        double tLength = sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+        for (int a = 0; a < 3; a++)
+            t[a] = tLength > 0 ? t[a] / tLength : (a == 0 ? 1.0 : 0.0);
+        double along = n[0] * t[0] + n[1] * t[1] + n[2] * t[2];
+        for (int a = 0; a < 3; a++)
+            n[a] -= along * t[a];
+        double nLength = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (nLength < 1e-12)
+        {
+            // Straight segment: any direction perpendicular to the tangent will do
+            double axis[3] = { fabs(t[0]) < 0.9 ? 1.0 : 0.0, fabs(t[0]) < 0.9 ? 0.0 : 1.0, 0.0 };
+            n[0] = axis[1] * t[2] - axis[2] * t[1];
+            n[1] = axis[2] * t[0] - axis[0] * t[2];
+            n[2] = axis[0] * t[1] - axis[1] * t[0];
+            nLength = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        }
+        for (int a = 0; a < 3; a++)
+            n[a] /= nLength;
+        b[0] = t[1] * n[2] - t[2] * n[1];
+        b[1] = t[2] * n[0] - t[0] * n[2];
+        b[2] = t[0] * n[1] - t[1] * n[0];
+
+        for (int k = 0; k < sides; k++)
+        {
+            double angle = 2 * PI * k / sides;
+            double c = cos(angle) * radius;
+            double s = sin(angle) * radius;
+            for (int a = 0; a < 3; a++)
+            {
+                positions.push_back((float)(p[a] + c * n[a] + s * b[a]));
+            }
+        }
+    }
+}
+
+// Two triangles per quad between ring r0 and ring r1 (each `width` vertices wide, wrapping around)
+static void AppendQuadStrip(uint64_t r0, uint64_t r1, unsigned int width, std::vector<uint32_t>& indices)
+{
+    for (unsigned int k = 0; k < width; k++)
+    {
+        unsigned int k1 = (k + 1) % width;
+        uint32_t a = (uint32_t)(r0 + k), b = (uint32_t)(r0 + k1);
+        uint32_t c = (uint32_t)(r1 + k), d = (uint32_t)(r1 + k1);
+        indices.push_back(a); indices.push_back(c); indices.push_back(b);
+        indices.push_back(b); indices.push_back(c); indices.push_back(d);
+    }
+}
+
+bool ExportFibers(const std::vector<std::vector<double>>& points, const std::string& path, const ExportOptions& options)
+{
+    PROFILE_FUNCTION();
+    std::unique_ptr<MeshWriter> writer = CreateMeshWriter(path);
+    if (!writer)
+    {
+        std::cout << "ExportFibers: unsupported format " << path << " (use .ply, .obj or .gltf)" << std::endl;
+        return false;
+    }
+    uint64_t numFibers = points.size();
+    uint64_t samples = GetFiberSampleCount(options.phiInc);
+    int sides = options.tubeSides;
+    if (numFibers == 0)
+    {
+        std::cout << "ExportFibers: there are no fibers to export" << std::endl;
+        return false;
+    }
+
+    // setStarts[k] is the first fiber of surface set k; the last entry is numFibers
+    std::vector<uint64_t> setStarts(1, 0);
+    for (size_t k = 0; k < options.setSizes.size(); k++)
+    {
+        setStarts.push_back(setStarts.back() + options.setSizes[k]);
+    }
+    if (options.setSizes.empty())
+    {
+        setStarts.push_back(numFibers);
+    }
+    if (setStarts.back() != numFibers)
+    {
+        std::cout << "ExportFibers: the set sizes cover " << setStarts.back() << " of " << numFibers << " fibers" << std::endl;
+        return false;
+    }
+    uint64_t numBands = 0;
+    if (options.geometry == ExportGeometry::Tori)
+    {
+        unsigned int minimum = options.closeSurface ? 3 : 2;
+        for (size_t k = 0; k + 1 < setStarts.size(); k++)
+        {
+            uint64_t setFibers = setStarts[k + 1] - setStarts[k];
+            if (setFibers < minimum)
+            {
+                std::cout << "ExportFibers: a " << (options.closeSurface ? "closed " : "") << "surface needs at least " << minimum << " fibers" << std::endl;
+                return false;
+            }
+            numBands += options.closeSurface ? setFibers : setFibers - 1;
+        }
+    }
+
+    uint64_t numVertices, numPrimitives;
+    int verticesPerPrimitive;
+    switch (options.geometry)
+    {
+    case ExportGeometry::Tubes:
+        numVertices = numFibers * samples * sides;
+        numPrimitives = numVertices * 2;
+        verticesPerPrimitive = 3;
+        break;
+    case ExportGeometry::Tori:
+        numVertices = numFibers * samples;
+        numPrimitives = numBands * samples * 2;
+        verticesPerPrimitive = 3;
+        break;
+    default:
+        numVertices = numFibers * samples;
+        numPrimitives = numVertices;    //closed loop of segments per fiber
+        verticesPerPrimitive = 2;
+        break;
+    }
+    if (numVertices > 0xFFFFFFFFull)
+    {
+        std::cout << "ExportFibers: " << numVertices << " vertices do not fit 32-bit indices" << std::endl;
+        return false;
+    }
+    if (!writer->Begin(path, numVertices, numPrimitives, verticesPerPrimitive))
+    {
+        return false;
+    }
+
+    // Every fiber has the same sample count, so its index pattern is built once and offset per fiber
+    std::vector<uint32_t> ringIndices;
+    if (options.geometry == ExportGeometry::Fibers)
+        BuildRingIndices(RingTopology::LineSegments, (unsigned int)samples, 1, ringIndices);
+    else if (options.geometry == ExportGeometry::Tubes)
+        BuildRingIndices(RingTopology::TubeTriangles, (unsigned int)samples, sides, ringIndices);
+
+    FiberSet chunk;
+    std::vector<float> positions;
+    std::vector<unsigned char> colors;
+    std::vector<uint32_t> indices;
+    unsigned int chunkFibers = options.chunkFibers > 0 ? options.chunkFibers : 1;
+    size_t set = 0;
+    for (uint64_t begin = 0; begin < numFibers; begin += chunkFibers)
+    {
+        uint64_t end = begin + chunkFibers < numFibers ? begin + chunkFibers : numFibers;
+        BuildFibers(points, (size_t)begin, (size_t)end, chunk, options.phiInc, options.precision);
+        positions.clear();
+        colors.clear();
+        indices.clear();
+
+        for (uint64_t i = begin; i < end; i++)
+        {
+            unsigned int local = (unsigned int)(i - begin);
+            const float* vertices = &chunk.vertices[(size_t)chunk.firsts[local] * 3];
+            unsigned char rgba[4];
+            for (int c = 0; c < 4; c++)
+            {
+                float value = chunk.colors[local * 4 + c];
+                rgba[c] = (unsigned char)(value <= 0.0f ? 0 : value >= 1.0f ? 255 : value * 255.0f + 0.5f);
+            }
+
+            uint64_t ringVertices = options.geometry == ExportGeometry::Tubes ? samples * sides : samples;
+            if (options.geometry == ExportGeometry::Tubes)
+            {
+                GenerateTube(vertices, (unsigned int)samples, options.tubeRadius, sides, positions);
+            }
+            else
+            {
+                positions.insert(positions.end(), vertices, vertices + samples * 3);
+            }
+            for (uint64_t v = 0; v < ringVertices; v++)
+            {
+                colors.insert(colors.end(), rgba, rgba + 4);
+            }
+
+            if (options.geometry != ExportGeometry::Tori)
+            {
+                uint32_t base = (uint32_t)(i * ringVertices); //numVertices fits 32 bits, checked above
+                for (size_t k = 0; k < ringIndices.size(); k++)
+                {
+                    indices.push_back(base + ringIndices[k]);
+                }
+            }
+            else
+            {
+                while (i >= setStarts[set + 1])
+                {
+                    set++;
+                }
+                if (i > setStarts[set])
+                {
+                    // Band between the previous fiber and this one; both are already written when the faces land
+                    AppendQuadStrip((i - 1) * samples, i * samples, (unsigned int)samples, indices);
+                }
+            }
+        }
+
+        writer->WriteVertices(&positions[0], &colors[0], positions.size() / 3);
+        if (!indices.empty())
+        {
+            writer->WritePrimitives(&indices[0], indices.size() / verticesPerPrimitive);
+        }
+    }
+    if (options.geometry == ExportGeometry::Tori && options.closeSurface)
+    {
+        indices.clear();
+        for (size_t k = 0; k + 1 < setStarts.size(); k++)
+        {
+            AppendQuadStrip((setStarts[k + 1] - 1) * samples, setStarts[k] * samples, (unsigned int)samples, indices); //close each surface
+        }
+        writer->WritePrimitives(&indices[0], indices.size() / verticesPerPrimitive);
+    }
+    return writer->End();
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BufferedFile.hpp"
+#include "FiberSet.hpp"
+
+enum class ExportGeometry
+{
+    Fibers,     //one closed polyline per fiber
+    Tubes,      //a triangle tube swept around each fiber
+    Tori        //surface joining consecutive fibers of a set; a torus when the set is closed (closeSurface)
+};
+
+struct ExportOptions
+{
+    ExportGeometry geometry = ExportGeometry::Fibers;
+    float tubeRadius = 2.0f;
+    int tubeSides = 8;
+    unsigned int chunkFibers = 256;     //fibers generated and written per step; bounds memory use
+    // Surfaces: fibers per set, back to back in the base points (empty means one set). Each set is its
+    // own surface, and closeSurface adds the band from its last fiber back to its first, for base points
+    // on a closed curve such as a great circle or an elevation circle.
+    std::vector<unsigned int> setSizes;
+    bool closeSurface = false;
+    double phiInc = FIBER_PHI_STEP;
+    FiberPrecision precision = FiberPrecision::Double;
+};
+
+// Receives geometry chunk by chunk. Totals are known before anything is generated, so writers can lay out
+// every section of the file up front and stream into each one independently.
+class MeshWriter
+{
+public:
+    virtual ~MeshWriter() {}
+
+    virtual bool Begin(const std::string& path, uint64_t numVertices, uint64_t numPrimitives, int verticesPerPrimitive) = 0;
+    virtual void WriteVertices(const float* positions, const unsigned char* colors, size_t count) = 0; //xyz, rgba8
+    virtual void WritePrimitives(const uint32_t* indices, size_t count) = 0;  //global vertex indices, count primitives
+    virtual bool End() = 0;
+};
+
+// Binary little-endian PLY with an edge element for lines or a face element for triangles
+class PlyWriter : public MeshWriter
+{
+public:
+    bool Begin(const std::string& path, uint64_t numVertices, uint64_t numPrimitives, int verticesPerPrimitive) override;
+    void WriteVertices(const float* positions, const unsigned char* colors, size_t count) override;
+    void WritePrimitives(const uint32_t* indices, size_t count) override;
+    bool End() override;
+
+private:
+    BufferedFile m_File;
+    std::unique_ptr<RegionWriter> m_Vertices;
+    std::unique_ptr<RegionWriter> m_Primitives;
+    int m_VerticesPerPrimitive;
+};
+
+// Wavefront OBJ with "v x y z r g b" vertex colors, "l" segments or "f" triangles
+class ObjWriter : public MeshWriter
+{
+public:
+    bool Begin(const std::string& path, uint64_t numVertices, uint64_t numPrimitives, int verticesPerPrimitive) override;
+    void WriteVertices(const float* positions, const unsigned char* colors, size_t count) override;
+    void WritePrimitives(const uint32_t* indices, size_t count) override;
+    bool End() override;
+
+private:
+    BufferedFile m_File;
+    std::unique_ptr<RegionWriter> m_Output;
+    int m_VerticesPerPrimitive;
+};
+
+// glTF 2.0: a .gltf document written last (it carries counts and bounds) plus a .bin buffer holding
+// positions, RGBA8 colors and uint32 indices in three regions streamed side by side
+class GltfWriter : public MeshWriter
+{
+public:
+    bool Begin(const std::string& path, uint64_t numVertices, uint64_t numPrimitives, int verticesPerPrimitive) override;
+    void WriteVertices(const float* positions, const unsigned char* colors, size_t count) override;
+    void WritePrimitives(const uint32_t* indices, size_t count) override;
+    bool End() override;
+
+private:
+    std::string m_Path;
+    std::string m_BinaryName;
+    BufferedFile m_File;
+    std::unique_ptr<RegionWriter> m_Positions;
+    std::unique_ptr<RegionWriter> m_Colors;
+    std::unique_ptr<RegionWriter> m_Indices;
+    uint64_t m_NumVertices;
+    uint64_t m_NumPrimitives;
+    int m_VerticesPerPrimitive;
+    float m_Min[3];
+    float m_Max[3];
+};
+
+// Picks a writer from the file extension (.ply, .obj, .gltf); nullptr for anything else
+std::unique_ptr<MeshWriter> CreateMeshWriter(const std::string& path);
+
+// Generates the fibers of the given base points chunk by chunk and streams them to path
+bool ExportFibers(const std::vector<std::vector<double>>& points, const std::string& path, const ExportOptions& options);
\ No newline at end of file
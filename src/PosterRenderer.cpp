@@ -0,0 +1,120 @@
+#include "PosterRenderer.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "AsyncReadback.hpp"
+#include "FrameBuffer.hpp"
+#include "ImageWriter.hpp"
+
+int GetMaxTileSize()
+{
+    GLint maxTexture = 0, maxRenderbuffer = 0;
+    GLint maxViewport[2] = { 0, 0 };
+    GLCall(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTexture));
+    GLCall(glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRenderbuffer));
+    GLCall(glGetIntegerv(GL_MAX_VIEWPORT_DIMS, maxViewport));
+    int size = maxTexture;
+    if (maxRenderbuffer < size) size = maxRenderbuffer;
+    if (maxViewport[0] < size) size = maxViewport[0];
+    if (maxViewport[1] < size) size = maxViewport[1];
+    return size;
+}
+
+bool RenderPoster(const PosterOptions& options, const Camera& camera,
+                  const std::function<void(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix)>& drawScene)
+{
+    int maxTile = GetMaxTileSize();
+    int tileSize = options.tileSize > 0 ? options.tileSize : 2048;
+    if (tileSize > maxTile)
+    {
+        tileSize = maxTile;
+    }
+    int tilesX = (options.width + tileSize - 1) / tileSize;
+    int tilesY = (options.height + tileSize - 1) / tileSize;
+
+    ImageWriter writer;
+    if (!writer.Open(options.output, options.width, options.height, 3))
+    {
+        return false;
+    }
+
+    FrameBuffer fbo;
+    fbo.AttachTexture(tileSize, tileSize);
+    fbo.AttachDepthBuffer();
+    AsyncReadback readback(tileSize, tileSize, options.ringSize);
+
+    // One row of tiles, top to bottom, in output order
+    std::vector<unsigned char> band((size_t)options.width * tileSize * 3);
+    std::vector<unsigned char> pixels;
+    int currentBand = 0;
+    int bandHeight = 0;
+    bool ok = true;
+
+    // Tiles are issued from the top band down; readbacks complete in the same order
+    auto retrieveOldest = [&]() {
+        int width, height;
+        long long tag;
+        if (!readback.Retrieve(pixels, width, height, tag, true))
+        {
+            ok = false;
+            return;
+        }
+        int tileBand = (int)(tag / tilesX);
+        int column = (int)(tag % tilesX);
+        if (tileBand != currentBand)
+        {
+            ok = writer.WriteRows(&band[0], bandHeight) && ok;
+            currentBand = tileBand;
+        }
+        bandHeight = height;
+        for (int y = 0; y < height; y++)
+        {
+            const unsigned char* source = &pixels[(size_t)(height - 1 - y) * width * 4];
+            unsigned char* target = &band[((size_t)y * options.width + (size_t)column * tileSize) * 3];
+            for (int x = 0; x < width; x++)
+            {
+                target[x * 3 + 0] = source[x * 4 + 0];
+                target[x * 3 + 1] = source[x * 4 + 1];
+                target[x * 3 + 2] = source[x * 4 + 2];
+            }
+        }
+    };
+
+    fbo.Bind();
+    for (int bandIndex = 0; bandIndex < tilesY; bandIndex++)
+    {
+        // Band 0 is the top of the image, which is the top of the frustum
+        int y1 = options.height - bandIndex * tileSize;
+        int y0 = y1 - tileSize > 0 ? y1 - tileSize : 0;
+        for (int column = 0; column < tilesX; column++)
+        {
+            int x0 = column * tileSize;
+            int x1 = x0 + tileSize < options.width ? x0 + tileSize : options.width;
+
+            glm::mat4 projection = camera.GetTileProjectionMatrix(
+                (float)x0 / options.width, (float)y0 / options.height,
+                (float)x1 / options.width, (float)y1 / options.height);
+            GLCall(glViewport(0, 0, x1 - x0, y1 - y0));
+            drawScene(camera.GetViewMatrix(), projection);
+
+            if (readback.GetInFlight() == readback.GetRingSize())
+            {
+                retrieveOldest();
+            }
+            readback.Request(0, 0, x1 - x0, y1 - y0, (long long)bandIndex * tilesX + column);
+        }
+    }
+    while (readback.GetInFlight() > 0)
+    {
+        retrieveOldest();
+    }
+    ok = writer.WriteRows(&band[0], bandHeight) && ok;
+    ok = writer.Close() && ok;
+
+    fbo.Unbind();
+    readback.Delete();
+    fbo.Delete();
+    return ok;
+}
\ No newline at end of file
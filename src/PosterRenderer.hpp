@@ -0,0 +1,28 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <functional>
+#include <string>
+
+#include "glm/glm.hpp"
+
+#include "Camera.hpp"
+
+struct PosterOptions
+{
+    int width = 16384;
+    int height = 16384;
+    int tileSize = 0;       //0 = largest size the driver allows, capped at 2048
+    int ringSize = 4;       //tiles in flight between render and readback
+    std::string output = "poster.png";
+};
+
+// Renders an image larger than GL_MAX_TEXTURE_SIZE by splitting the camera frustum into tiles.
+// Each tile is drawn with an off-center projection into one small FBO, read back asynchronously and
+// written out a band of tiles at a time, so memory use is one row of tiles rather than the whole image.
+// drawScene receives the view and tile projection matrices and must draw into the bound framebuffer.
+bool RenderPoster(const PosterOptions& options, const Camera& camera,
+                  const std::function<void(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix)>& drawScene);
+
+// Largest square tile the current context can render and read back
+int GetMaxTileSize();
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>
+
+// Resident memory of this process in bytes, 0 where the platform does not report it
+size_t GetPeakResidentBytes();
+size_t GetCurrentResidentBytes();
\ No newline at end of file
@@ -0,0 +1,153 @@
+#include "Profiler.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+// Per-thread event storage. Buffers are owned by the registry rather than the thread, so events
+// from threads that have already exited (pool workers, encoders) still make it into the trace.
+namespace
+{
+    struct ProfileEvent
+    {
+        const char* name;
+        uint64_t start;
+        uint64_t end;
+    };
+
+    const size_t g_ThreadBufferCapacity = 1 << 16; //events kept per thread; older ones are overwritten
+
+    struct ThreadBuffer
+    {
+        std::mutex mutex; //only contended while a trace is being written
+        std::vector<ProfileEvent> events;
+        size_t next = 0;
+        bool wrapped = false;
+        unsigned int id = 0;
+        std::string name;
+    };
+
+    std::mutex g_RegistryMutex;
+    std::vector<ThreadBuffer*> g_Buffers;
+    thread_local ThreadBuffer* t_Buffer = nullptr;
+    thread_local const char* t_ThreadName = nullptr;
+
+    const std::chrono::steady_clock::time_point g_Epoch = std::chrono::steady_clock::now();
+
+    ThreadBuffer* GetThreadBuffer()
+    {
+        if (!t_Buffer)
+        {
+            ThreadBuffer* buffer = new ThreadBuffer();
+            buffer->events.resize(g_ThreadBufferCapacity);
+            if (t_ThreadName)
+                buffer->name = t_ThreadName;
+            std::lock_guard<std::mutex> lock(g_RegistryMutex);
+            buffer->id = (unsigned int)g_Buffers.size() + 1;
+            g_Buffers.push_back(buffer);
+            t_Buffer = buffer;
+        }
+        return t_Buffer;
+    }
+
+    void WriteEscaped(FILE* file, const char* s)
+    {
+        for (; *s; s++)
+        {
+            if (*s == '"' || *s == '\\')
+                fputc('\\', file);
+            fputc(*s, file);
+        }
+    }
+}
+
+std::atomic<bool> Profiler::s_Enabled(false);
+
+void Profiler::SetEnabled(bool enabled)
+{
+    s_Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+    // Buffers are only allocated by the first recorded zone; until then just remember the name
+    t_ThreadName = name;
+    if (t_Buffer)
+    {
+        std::lock_guard<std::mutex> lock(t_Buffer->mutex);
+        t_Buffer->name = name;
+    }
+}
+
+uint64_t Profiler::Now()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_Epoch).count();
+}
+
+void Profiler::Record(const char* name, uint64_t start, uint64_t end)
+{
+    ThreadBuffer* buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    ProfileEvent& event = buffer->events[buffer->next];
+    event.name = name;
+    event.start = start;
+    event.end = end;
+    if (++buffer->next == g_ThreadBufferCapacity)
+    {
+        buffer->next = 0;
+        buffer->wrapped = true;
+    }
+}
+
+bool Profiler::WriteTrace(const std::string& path)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file)
+    {
+        std::cout << "Profiler: could not open " << path << std::endl;
+        return false;
+    }
+    fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    bool first = true;
+
+    std::vector<ThreadBuffer*> buffers;
+    {
+        std::lock_guard<std::mutex> lock(g_RegistryMutex);
+        buffers = g_Buffers;
+    }
+    size_t numEvents = 0;
+    for (size_t b = 0; b < buffers.size(); b++)
+    {
+        ThreadBuffer* buffer = buffers[b];
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        if (!buffer->name.empty())
+        {
+            fprintf(file, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": \"",
+                first ? "" : ",\n", buffer->id);
+            WriteEscaped(file, buffer->name.c_str());
+            fprintf(file, "\"}}");
+            first = false;
+        }
+        size_t count = buffer->wrapped ? g_ThreadBufferCapacity : buffer->next;
+        size_t begin = buffer->wrapped ? buffer->next : 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            const ProfileEvent& event = buffer->events[(begin + i) % g_ThreadBufferCapacity];
+            // Complete events, timestamps in microseconds
+            fprintf(file, "%s{\"name\": \"", first ? "" : ",\n");
+            WriteEscaped(file, event.name);
+            fprintf(file, "\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}",
+                buffer->id, event.start / 1000.0, (event.end - event.start) / 1000.0);
+            first = false;
+        }
+        numEvents += count;
+    }
+    fprintf(file, "\n]}\n");
+    bool ok = ferror(file) == 0;
+    ok = fclose(file) == 0 && ok;
+    if (ok)
+        std::cout << "Wrote " << numEvents << " profiler events to " << path << std::endl;
+    return ok;
+}
\ No newline at end of file
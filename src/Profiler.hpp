@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped CPU zones recorded into per-thread ring buffers and written out as a Chrome trace
+// (chrome://tracing, ui.perfetto.dev). While disabled a zone costs one relaxed atomic load;
+// building with HOPF_DISABLE_PROFILING removes the zones entirely.
+//
+//     void Hopf::UpdateCircles(...)
+//     {
+//         PROFILE_FUNCTION();
+//         ...
+//         { PROFILE_SCOPE("Upload"); ... }
+//     }
+//
+// Zone names must be string literals (or otherwise outlive the trace).
+
+class Profiler
+{
+public:
+    static void SetEnabled(bool enabled);
+    static inline bool IsEnabled() { return s_Enabled.load(std::memory_order_relaxed); }
+
+    // Labels the calling thread in the trace; name must outlive the thread
+    static void SetThreadName(const char* name);
+    // Writes the most recent events of every thread that has recorded a zone
+    static bool WriteTrace(const std::string& path);
+
+    static uint64_t Now(); //ns since the profiler was first used
+    static void Record(const char* name, uint64_t start, uint64_t end);
+
+private:
+    static std::atomic<bool> s_Enabled;
+};
+
+class ProfileZone
+{
+public:
+    inline explicit ProfileZone(const char* name)
+        : m_Name(Profiler::IsEnabled() ? name : nullptr), m_Start(m_Name ? Profiler::Now() : 0)
+    {
+    }
+    inline ~ProfileZone()
+    {
+        if (m_Name)
+            Profiler::Record(m_Name, m_Start, Profiler::Now());
+    }
+
+private:
+    ProfileZone(const ProfileZone&);
+    ProfileZone& operator=(const ProfileZone&);
+
+    const char* m_Name;
+    uint64_t m_Start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef HOPF_DISABLE_PROFILING
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#else
+#define PROFILE_SCOPE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#endif
\ No newline at end of file
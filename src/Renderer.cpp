@@ -1,8 +1,10 @@
 #include <iostream>
 #include "Renderer.hpp"
+#include "GLStats.hpp"
 
 void GLClearError()
 {
+	GLStats::CountCall(); //every GLCall goes through here
 	while (glGetError() != GL_NO_ERROR); //while there is an error
 }
 
@@ -26,6 +28,7 @@ void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader&
 	shader.Bind();
 	va.Bind();
 	ib.Bind();
-	GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr));
+	GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, ib.GetIndices()));
+	GLStats::CountDraw(ib.GetCount());
 }
 
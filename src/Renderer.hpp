@@ -5,7 +5,14 @@
 #include "IndexBuffer.hpp"
 #include "Shader.hpp"
 
-#define ASSERT(x) if (!(x)) __debugbreak(); //if x is false, break
+#ifdef _MSC_VER
+#define DEBUG_BREAK() __debugbreak()
+#else
+#include <csignal>
+#define DEBUG_BREAK() raise(SIGTRAP)
+#endif
+
+#define ASSERT(x) if (!(x)) DEBUG_BREAK(); //if x is false, break
 #define GLCall(x) GLClearError();\
 	x;\
 	ASSERT(GLLogCall(#x, __FILE__, __LINE__)) //clear the error, call x, assert that there is no error
@@ -0,0 +1,3 @@
+#include "Residency.hpp"
+
+bool Residency::s_GpuResident = false;
\ No newline at end of file
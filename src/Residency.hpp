@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vector>
+
+// GPU-resident geometry. When on, Hopf, Points and Sphere free their CPU copies of vertex data
+// as soon as it is uploaded, keeping only what drawing needs (counts, per-fiber ranges and colors).
+// Anything that asks for the data again (Hopf::GetS3Circles, a re-upload) rebuilds it from the base
+// points. Exports generate from the base points in any case.
+class Residency
+{
+public:
+    static inline void SetGpuResident(bool resident) { s_GpuResident = resident; }
+    static inline bool IsGpuResident() { return s_GpuResident; }
+
+private:
+    static bool s_GpuResident;
+};
+
+// clear() keeps the capacity; swapping with an empty vector actually returns the memory
+template<typename T>
+inline void ReleaseStorage(std::vector<T>& v)
+{
+    std::vector<T>().swap(v);
+}
\ No newline at end of file
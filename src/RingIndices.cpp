@@ -0,0 +1,32 @@
+#include "RingIndices.hpp"
+
+void BuildRingIndices(RingTopology topology, unsigned int ringSize, unsigned int sides, std::vector<uint32_t>& indices)
+{
+    indices.clear();
+    switch (topology)
+    {
+    case RingTopology::LineSegments:
+        for (unsigned int j = 0; j < ringSize; j++)
+        {
+            indices.push_back(j);
+            indices.push_back((j + 1) % ringSize);
+        }
+        break;
+    case RingTopology::TubeTriangles:
+        // Ring j is vertices [j * sides, (j + 1) * sides); quads join ring j to ring j + 1, the last to the first
+        for (unsigned int j = 0; j < ringSize; j++)
+        {
+            uint32_t r0 = j * sides;
+            uint32_t r1 = ((j + 1) % ringSize) * sides;
+            for (unsigned int k = 0; k < sides; k++)
+            {
+                unsigned int k1 = (k + 1) % sides;
+                uint32_t a = r0 + k, b = r0 + k1;
+                uint32_t c = r1 + k, d = r1 + k1;
+                indices.push_back(a); indices.push_back(c); indices.push_back(b);
+                indices.push_back(b); indices.push_back(c); indices.push_back(d);
+            }
+        }
+        break;
+    }
+}
\ No newline at end of file
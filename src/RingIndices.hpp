@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Index patterns for one ring of fiber samples. Every fiber with the same sample count has the same
+// topology, so a pattern is built once per ring size and offset per fiber.
+enum class RingTopology
+{
+    LineSegments,       //(j, j+1) pairs closing back to 0, for GL_LINES and edge lists
+    TubeTriangles       //two triangles per quad between consecutive rings of `sides` vertices, wrapping both ways
+};
+
+// Replaces indices with the pattern, relative to the ring's first vertex. sides only matters for tubes.
+void BuildRingIndices(RingTopology topology, unsigned int ringSize, unsigned int sides, std::vector<uint32_t>& indices);
\ No newline at end of file
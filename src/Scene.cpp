@@ -0,0 +1,75 @@
+#include "Scene.hpp"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "AllocationTracker.hpp"
+
+static const glm::vec3 groundTranslation(0, -1000.0f, 0);
+
+std::vector<std::string> GetScenePassNames()
+{
+    std::vector<std::string> names(SCENE_PASS_COUNT);
+    names[SCENE_PASS_AXIS] = "axis";
+    names[SCENE_PASS_GROUND] = "ground";
+    names[SCENE_PASS_FIBERS] = "fibers";
+    names[SCENE_PASS_PREVIEW] = "preview";
+    names[SCENE_PASS_IMGUI] = "imgui";
+    return names;
+}
+
+void ConfigureRenderState(int width, int height)
+{
+    GLCall(glEnable(GL_CULL_FACE));
+    GLCall(glCullFace(GL_FRONT));
+    GLCall(glFrontFace(GL_CCW));
+    GLCall(glEnable(GL_BLEND));
+    GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+    GLCall(glViewport(0, 0, width, height));
+    GLCall(glEnable(GL_DEPTH_TEST));
+    GLCall(glDepthFunc(GL_LESS));
+}
+
+void DrawScene(const Renderer& renderer, Shader& shader, Shader& fiberShader, Axis& axis, const Plane& plane, std::vector<Hopf>& hopfs,
+               const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, const SceneOptions& options,
+               GpuTimer* timer)
+{
+    ALLOC_SCOPE("DrawScene");
+    GLCall(glClearColor(0.529f, 0.828f, 0.952f, 1.0f));
+    renderer.Clear();
+    if (options.drawCoordinateAxis)
+    {   //Coordinate axis
+        if (timer) timer->Begin(SCENE_PASS_AXIS);
+        shader.Bind();
+        glm::mat4 model = glm::mat4(1.0f); //create a model matrix
+        glm::mat4 mvp = projectionMatrix * viewMatrix * model;
+        shader.SetUniformMat4f("u_MVP", mvp); //set the uniform
+        shader.SetUniform4f("u_Color", 1.0f, 1.0f, 1.0f, 1.0f); //set the uniform
+        glLineWidth(3.0f);
+        axis.Draw();
+        if (timer) timer->End(SCENE_PASS_AXIS);
+    }
+    if (options.drawGround)
+    {   //Green plane
+        if (timer) timer->Begin(SCENE_PASS_GROUND);
+        shader.Bind();
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), groundTranslation); //create a model matrix
+        glm::mat4 mvp = projectionMatrix * viewMatrix * model;
+        shader.SetUniform4f("u_Color", 0.482f, 0.62f, 0.451f, 1.0f); //set the uniform
+        shader.SetUniformMat4f("u_MVP", mvp); //set the uniform
+        plane.Draw();
+        if (timer) timer->End(SCENE_PASS_GROUND);
+    }
+    if (options.drawCircle)
+    {
+        if (timer) timer->Begin(SCENE_PASS_FIBERS);
+        fiberShader.Bind();
+        glm::mat4 model = glm::mat4(1.0f); //create a model matrix
+        glm::mat4 mvp = projectionMatrix * viewMatrix * model;
+        fiberShader.SetUniformMat4f("u_MVP", mvp); //set the uniform
+        for (size_t i = 0; i < hopfs.size(); i++)
+        {
+            hopfs[i].Draw(fiberShader);
+        }
+        if (timer) timer->End(SCENE_PASS_FIBERS);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Renderer.hpp"
+#include "Shader.hpp"
+#include "GpuTimer.hpp"
+#include "render_geom/CoordinateAxis/CoordinateAxis.hpp"
+#include "render_geom/Plane/Plane.hpp"
+#include "render_geom/Hopf/Hopf.hpp"
+
+struct SceneOptions
+{
+    bool drawGround = false;
+    bool drawCoordinateAxis = true;
+    bool drawCircle = true;
+};
+
+// Passes timed by the viewer's GpuTimer, in the order of GetScenePassNames()
+enum ScenePass
+{
+    SCENE_PASS_AXIS,
+    SCENE_PASS_GROUND,
+    SCENE_PASS_FIBERS,
+    SCENE_PASS_PREVIEW,
+    SCENE_PASS_IMGUI,
+    SCENE_PASS_COUNT
+};
+
+std::vector<std::string> GetScenePassNames();
+
+// GL state shared by the window and the headless renderer
+void ConfigureRenderState(int width, int height);
+
+// Clears the bound framebuffer and draws the axis, ground and fibers as seen from the main camera.
+// The fibers use fiberShader (per-vertex color), the rest the uniform-color shader.
+// With a timer, each of the three passes is wrapped in its query.
+void DrawScene(const Renderer& renderer, Shader& shader, Shader& fiberShader, Axis& axis, const Plane& plane, std::vector<Hopf>& hopfs,
+               const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, const SceneOptions& options,
+               GpuTimer* timer = nullptr);
\ No newline at end of file
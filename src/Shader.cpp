@@ -1,4 +1,6 @@
 #include "Shader.hpp"
+#include "Profiler.hpp"
+#include "GLStats.hpp"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -110,6 +112,8 @@ unsigned int Shader::CreateShader(const std::string& vertexShader, const std::st
 
 void Shader::Bind() const
 {
+    PROFILE_SCOPE("Shader::Bind");
+    GLStats::CountProgramBind();
     GLCall(glUseProgram(m_RendererID)); //use the shader
 }
 void Shader::Unbind() const
@@ -120,27 +124,32 @@ void Shader::Unbind() const
 //Set uniforms
 void Shader::SetUniform1i(const std::string& name, int v0)
 {
+	GLStats::CountUniform();
 	GLCall(glUniform1i(GetUniformLocation(name), v0)); //set the uniform
 }
 
 void Shader::SetUniform1f(const std::string& name, float v0)
 {
+	GLStats::CountUniform();
 	GLCall(glUniform1f(GetUniformLocation(name), v0)); //set the uniform
 
 }
 
 void Shader::SetUniform3f(const std::string& name, float v0, float v1, float v2)
 {
+    GLStats::CountUniform();
     GLCall(glUniform3f(GetUniformLocation(name), v0, v1, v2)); //set the uniform
 }
 
 void Shader::SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3)
 {
+    GLStats::CountUniform();
     GLCall(glUniform4f(GetUniformLocation(name), v0, v1, v2, v3)); //set the uniform)
 }
 
 void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
 {
+    GLStats::CountUniform();
     GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0])); //set the uniform
 }
 
@@ -0,0 +1,192 @@
+#include "StreamBuffer.hpp"
+#include "Profiler.hpp"
+#include "GLStats.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static const unsigned int s_RegionAlignment = 256;
+
+StreamBuffer::StreamBuffer(unsigned int regionSize, unsigned int regions)
+    : m_Regions(regions ? regions : 1)
+{
+    Create(regionSize);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    Delete();
+}
+
+StreamBuffer::StreamBuffer(StreamBuffer&& other) noexcept
+    : m_RendererID(other.m_RendererID), m_RegionSize(other.m_RegionSize), m_Regions(other.m_Regions),
+      m_Current(other.m_Current), m_Written(other.m_Written), m_Persistent(other.m_Persistent),
+      m_Mapped(other.m_Mapped), m_Fences(std::move(other.m_Fences)), m_Waits(other.m_Waits)
+{
+    other.m_RendererID = 0;
+    other.m_Mapped = nullptr;
+    other.m_Fences.clear();
+}
+
+StreamBuffer& StreamBuffer::operator=(StreamBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        Delete();
+        m_RendererID = other.m_RendererID;
+        m_RegionSize = other.m_RegionSize;
+        m_Regions = other.m_Regions;
+        m_Current = other.m_Current;
+        m_Written = other.m_Written;
+        m_Persistent = other.m_Persistent;
+        m_Mapped = other.m_Mapped;
+        m_Fences = std::move(other.m_Fences);
+        m_Waits = other.m_Waits;
+        other.m_RendererID = 0;
+        other.m_Mapped = nullptr;
+        other.m_Fences.clear();
+    }
+    return *this;
+}
+
+void StreamBuffer::Create(unsigned int regionSize)
+{
+    // Regions start on an alignment boundary so every offset suits any vertex attribute
+    regionSize = regionSize ? regionSize : 1;
+    m_RegionSize = (regionSize + s_RegionAlignment - 1) / s_RegionAlignment * s_RegionAlignment;
+    m_Current = 0;
+    m_Written = false;
+    m_Fences.assign(m_Regions, (GLsync)0);
+    GLCall(glGenBuffers(1, &m_RendererID));
+    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+
+    m_Persistent = false;
+    if ((GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage) && glBufferStorage)
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLsizeiptr size = (GLsizeiptr)m_RegionSize * m_Regions;
+        GLCall(glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags));
+        GLCall(m_Mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+        m_Persistent = m_Mapped != nullptr;
+        if (!m_Persistent)
+        {
+            // Immutable storage cannot be respecified, so start over with a plain buffer
+            std::cout << "[StreamBuffer] persistent mapping failed, falling back to orphaning" << std::endl;
+            GLCall(glDeleteBuffers(1, &m_RendererID));
+            GLCall(glGenBuffers(1, &m_RendererID));
+            GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+        }
+    }
+    if (!m_Persistent)
+    {
+        m_Regions = 1;
+        m_Fences.assign(1, (GLsync)0);
+        GLCall(glBufferData(GL_ARRAY_BUFFER, m_RegionSize, nullptr, GL_STREAM_DRAW));
+    }
+    GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
+size_t StreamBuffer::Write(const void* data, unsigned int size)
+{
+    PROFILE_SCOPE("StreamBuffer::Write");
+    if (size > m_RegionSize || !m_RendererID)
+    {
+        // Grow with headroom so a slider dragged upwards does not reallocate on every step
+        unsigned int regions = m_Persistent ? m_Regions : DefaultRegions;
+        Delete();
+        m_Regions = regions;
+        unsigned long long grown = size + size / 2ull;
+        Create((unsigned int)std::min(grown, 0xFFFFFF00ull)); //keeps the aligned region within 32 bits
+    }
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    if (!m_Persistent)
+    {
+        GLStats::CountBufferBind();
+        GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+        GLCall(glBufferData(GL_ARRAY_BUFFER, m_RegionSize, nullptr, GL_STREAM_DRAW)); //orphan: draws in flight keep the old storage
+        GLCall(void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+        if (mapped)
+        {
+            memcpy(mapped, data, size);
+        }
+        GLCall(glUnmapBuffer(GL_ARRAY_BUFFER));
+        GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+        GLStats::CountUpload(size);
+        return 0;
+    }
+
+    // Every command reading the current region has been issued, so a fence now covers all of them
+    if (m_Written)
+    {
+        if (m_Fences[m_Current])
+        {
+            GLCall(glDeleteSync(m_Fences[m_Current]));
+        }
+        GLCall(m_Fences[m_Current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        m_Current = (m_Current + 1) % m_Regions;
+    }
+    GLsync fence = m_Fences[m_Current];
+    if (fence)
+    {
+        GLenum status;
+        GLCall(status = glClientWaitSync(fence, 0, 0));
+        if (status == GL_TIMEOUT_EXPIRED)
+        {
+            m_Waits++;
+            do
+            {
+                GLCall(status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull)); //1s per attempt
+            } while (status == GL_TIMEOUT_EXPIRED);
+        }
+        GLCall(glDeleteSync(fence));
+        m_Fences[m_Current] = 0;
+    }
+
+    size_t offset = (size_t)m_Current * m_RegionSize; //regions together may pass 4 GiB
+    memcpy(m_Mapped + offset, data, size); //coherent mapping: visible to the GPU without a flush
+    m_Written = true;
+    GLStats::CountUpload(size);
+    return offset;
+}
+
+void StreamBuffer::Bind() const
+{
+    GLStats::CountBufferBind();
+    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+}
+
+void StreamBuffer::Unbind() const
+{
+    GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
+void StreamBuffer::Delete()
+{
+    for (size_t i = 0; i < m_Fences.size(); i++)
+    {
+        if (m_Fences[i])
+        {
+            GLCall(glDeleteSync(m_Fences[i]));
+        }
+    }
+    m_Fences.clear();
+    if (m_RendererID)
+    {
+        if (m_Mapped)
+        {
+            GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+            GLCall(glUnmapBuffer(GL_ARRAY_BUFFER));
+            GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+        }
+        GLCall(glDeleteBuffers(1, &m_RendererID));
+    }
+    m_RendererID = 0;
+    m_Mapped = nullptr;
+    m_Persistent = false;
+    m_Written = false;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+
+#include "Renderer.hpp"
+
+// Vertex data that is rewritten while the GPU may still be drawing the previous version.
+// With GL 4.4 or ARB_buffer_storage the buffer holds a ring of regions (three by default) and stays
+// persistently mapped; each Write fences the region it leaves and fills the next one once the fence
+// placed there a full turn earlier has signalled, so the CPU only waits when it laps the GPU. On GL 3.3
+// the buffer is orphaned with glBufferData(nullptr) and refilled through glMapBufferRange instead,
+// which lets the driver hand out fresh storage rather than stall.
+class StreamBuffer
+{
+public:
+    static const unsigned int DefaultRegions = 3;
+
+    StreamBuffer() {};
+    StreamBuffer(unsigned int regionSize, unsigned int regions = DefaultRegions);
+    ~StreamBuffer();
+    StreamBuffer(StreamBuffer&& other) noexcept;
+    StreamBuffer& operator=(StreamBuffer&& other) noexcept;
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // Copies size bytes into the next region and returns their byte offset in the buffer. Data larger
+    // than a region reallocates the buffer, so vertex arrays are re-pointed (AddBuffer) after every Write.
+    size_t Write(const void* data, unsigned int size);
+    void Bind() const;
+    void Unbind() const;
+    void Delete();
+
+    inline bool IsValid() const { return m_RendererID != 0; }
+    inline bool IsPersistent() const { return m_Persistent; }
+    inline unsigned int GetRegionSize() const { return m_RegionSize; }
+    inline unsigned long long GetWaits() const { return m_Waits; } //writes that found their region still in use
+
+private:
+    void Create(unsigned int regionSize);
+
+    unsigned int m_RendererID = 0;
+    unsigned int m_RegionSize = 0;
+    unsigned int m_Regions = DefaultRegions;
+    unsigned int m_Current = 0;
+    bool m_Written = false;                 //whether the current region holds data the GPU may read
+    bool m_Persistent = false;
+    unsigned char* m_Mapped = nullptr;      //start of the persistent mapping
+    std::vector<GLsync> m_Fences;           //per region, 0 when nothing is pending
+    unsigned long long m_Waits = 0;
+};
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "ThreadPool.hpp"
+#include "Profiler.hpp"
+
+ThreadPool::ThreadPool(unsigned int numThreads, size_t maxQueued)
+    : m_MaxQueued(maxQueued), m_Active(0), m_Stopping(false)
+{
+    if (numThreads == 0)
+    {
+        numThreads = std::thread::hardware_concurrency();
+        if (numThreads == 0)
+            numThreads = 1;
+    }
+    for (unsigned int i = 0; i < numThreads; i++)
+    {
+        m_Threads.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_JobAvailable.notify_all();
+    m_SlotAvailable.notify_all();
+    for (size_t i = 0; i < m_Threads.size(); i++)
+    {
+        m_Threads[i].join();
+    }
+}
+
+void ThreadPool::Submit(const std::function<void()>& job)
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (m_MaxQueued > 0 && m_Jobs.size() >= m_MaxQueued && !m_Stopping)
+    {
+        m_SlotAvailable.wait(lock);
+    }
+    m_Jobs.push_back(job);
+    lock.unlock();
+    m_JobAvailable.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (!m_Jobs.empty() || m_Active > 0)
+    {
+        m_Idle.wait(lock);
+    }
+}
+
+void ThreadPool::WorkerLoop()
+{
+    Profiler::SetThreadName("ThreadPool worker");
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            while (m_Jobs.empty() && !m_Stopping)
+            {
+                m_JobAvailable.wait(lock);
+            }
+            if (m_Jobs.empty()) //stopping and nothing left to run
+            {
+                return;
+            }
+            job = m_Jobs.front();
+            m_Jobs.pop_front();
+            m_Active++;
+        }
+        m_SlotAvailable.notify_one();
+
+        job();
+
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Active--;
+            if (m_Jobs.empty() && m_Active == 0)
+            {
+                m_Idle.notify_all();
+            }
+        }
+    }
+}
\ No newline at end of file
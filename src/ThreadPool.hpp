@@ -0,0 +1,35 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads draining a FIFO of jobs. A non-zero maxQueued makes Submit block
+// while that many jobs are waiting, which bounds the memory held by queued work.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(unsigned int numThreads = 0, size_t maxQueued = 0); //0 threads = one per hardware thread
+    ~ThreadPool();
+
+    void Submit(const std::function<void()>& job);
+    void Wait(); //blocks until the queue is empty and every worker is idle
+
+    inline unsigned int GetThreadCount() const { return (unsigned int)m_Threads.size(); }
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_Threads;
+    std::deque<std::function<void()>> m_Jobs;
+    std::mutex m_Mutex;
+    std::condition_variable m_JobAvailable;
+    std::condition_variable m_SlotAvailable;
+    std::condition_variable m_Idle;
+    size_t m_MaxQueued;
+    size_t m_Active;
+    bool m_Stopping;
+};
\ No newline at end of file
@@ -0,0 +1,404 @@
+#include "Verify.hpp"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "GlobalFunctions.hpp"
+#include "Headless.hpp"
+#include "ThreadPool.hpp"
+#include "render_geom/Hopf/Hopf.hpp"
+
+// Tolerances for the double-precision reference; the vertices are stored as float, hence 1e-6 after projection
+static const double s_LiftTolerance = 1e-12;
+static const double s_CircleTolerance = 1e-6;     //relative to the circle radius, for float-stored vertices
+// The chart divides by sqrt(2 (1 + z)), which turns a rounding error in z into an error of about
+// eps / (1 + z) near the south pole; errors are weighted by min(1, 1 + z) so the tolerances hold everywhere
+static double GetConditionWeight(const std::vector<double>& point)
+{
+    return std::min(1.0, 1 + point[2]);
+}
+
+// Samples this close to the projection pole (0, 0, 0, 1) land arbitrarily far away and are left out
+// of the projected checks; they are still covered by the lift checks. Closer in, the projection scales
+// rounding errors by 1 / (1 - w), so projected errors are also weighted by min(1, 1 - w).
+static const double s_PoleDistance = 1e-4;
+
+std::vector<VerifyKernel> GetVerifyKernels()
+{
+    std::vector<VerifyKernel> kernels;
+
+    VerifyKernel kernel;
+    kernel.name = "BuildFiberSet/double";
+    kernel.tolerance = 1e-6;
+    kernel.exact = true;
+    kernel.build = [](const std::vector<std::vector<double>>& points, FiberSet& fiberSet, double phiInc) {
+        BuildFiberSet(points, fiberSet, phiInc, FiberPrecision::Double);
+    };
+    kernels.push_back(kernel);
+
+    kernel.name = "BuildFiberSet/float";
+    kernel.tolerance = 1e-5;
+    kernel.exact = false;
+    kernel.build = [](const std::vector<std::vector<double>>& points, FiberSet& fiberSet, double phiInc) {
+        BuildFiberSet(points, fiberSet, phiInc, FiberPrecision::Float);
+    };
+    kernels.push_back(kernel);
+
+    kernel.name = "BuildFiberSet/threads";
+    kernel.tolerance = 1e-6;
+    kernel.exact = true;
+    kernel.build = [](const std::vector<std::vector<double>>& points, FiberSet& fiberSet, double phiInc) {
+        ThreadPool pool;
+        BuildFiberSet(points, fiberSet, phiInc, FiberPrecision::Double, pool);
+    };
+    kernels.push_back(kernel);
+
+    kernel.name = "BuildFibers/chunks";
+    kernel.tolerance = 1e-6;
+    kernel.exact = true;
+    kernel.build = [](const std::vector<std::vector<double>>& points, FiberSet& fiberSet, double phiInc) {
+        // Reassembles 100-fiber chunks the way the exporters stream them
+        fiberSet.Clear();
+        FiberSet chunk;
+        for (size_t begin = 0; begin < points.size(); begin += 100)
+        {
+            BuildFibers(points, begin, std::min(begin + 100, points.size()), chunk, phiInc);
+            for (unsigned int i = 0; i < chunk.GetNumFibers(); i++)
+                fiberSet.firsts.push_back(chunk.firsts[i] + (unsigned int)fiberSet.GetNumVertices());
+            fiberSet.counts.insert(fiberSet.counts.end(), chunk.counts.begin(), chunk.counts.end());
+            fiberSet.vertices.insert(fiberSet.vertices.end(), chunk.vertices.begin(), chunk.vertices.end());
+            fiberSet.basePoints.insert(fiberSet.basePoints.end(), chunk.basePoints.begin(), chunk.basePoints.end());
+            fiberSet.colors.insert(fiberSet.colors.end(), chunk.colors.begin(), chunk.colors.end());
+            fiberSet.fiberHashes.insert(fiberSet.fiberHashes.end(), chunk.fiberHashes.begin(), chunk.fiberHashes.end());
+        }
+    };
+    kernels.push_back(kernel);
+
+    return kernels;
+}
+
+// Tracks the worst error of one check
+class VerifyCheck
+{
+public:
+    VerifyCheck(const std::string& name, double tolerance) : m_Name(name), m_Tolerance(tolerance), m_Worst(0.0), m_Where(-1), m_Count(0) {}
+
+    void Add(double error, long long where)
+    {
+        m_Count++;
+        if (!(error <= m_Worst)) //NaN counts as the worst error
+        {
+            m_Worst = error;
+            m_Where = where;
+        }
+    }
+
+    bool Report() const
+    {
+        bool pass = m_Worst <= m_Tolerance;
+        printf("%s %-48s worst %.3e (tolerance %.0e) over %lld samples", pass ? "PASS" : "FAIL", m_Name.c_str(),
+            m_Worst, m_Tolerance, m_Count);
+        if (!pass)
+            printf(", at fiber %lld", m_Where);
+        printf("\n");
+        return pass;
+    }
+
+private:
+    std::string m_Name;
+    double m_Tolerance;
+    double m_Worst;
+    long long m_Where;
+    long long m_Count;
+};
+
+static std::vector<std::vector<double>> GenerateVerifyPoints(const VerifyOptions& options)
+{
+    std::vector<std::vector<double>> points;
+    // Edge cases: the north pole (its fiber passes through the projection pole), near the south pole
+    // where 1 / sqrt(2 (1 + z)) blows up, and the equator. The south pole itself has no lift in this chart.
+    double nearSouth = sqrt(1 - (-1 + 1e-6) * (-1 + 1e-6));
+    points.push_back({ 0.0, 0.0, 1.0 });
+    points.push_back({ nearSouth, 0.0, -1 + 1e-6 });
+    points.push_back({ 1.0, 0.0, 0.0 });
+    points.push_back({ 0.0, -1.0, 0.0 });
+
+    // Uniform on S2 from a fixed generator so failures reproduce on every platform
+    std::mt19937 generator(options.seed);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    while ((int)points.size() < options.numPoints + 4)
+    {
+        double x = uniform(generator), y = uniform(generator), z = uniform(generator);
+        double length = sqrt(x * x + y * y + z * z);
+        if (length < 1e-3 || length > 1.0 || z / length < -1 + 1e-9)
+            continue;
+        points.push_back({ x / length, y / length, z / length });
+    }
+    return points;
+}
+
+static void CheckLifts(const std::vector<std::vector<double>>& points, double phiInc, int& failures)
+{
+    VerifyCheck norm("lift: |q| = 1", s_LiftTolerance);
+    VerifyCheck forward("lift: hopf(q) = base point", s_LiftTolerance);
+    std::vector<double> samples;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        LiftFiber(points[i], phiInc, samples);
+        double weight = GetConditionWeight(points[i]);
+        for (size_t j = 0; j < samples.size(); j += 4)
+        {
+            double a = samples[j], b = samples[j + 1], c = samples[j + 2], d = samples[j + 3];
+            norm.Add(fabs(sqrt(a * a + b * b + c * c + d * d) - 1) * weight, (long long)i);
+            // Hopf map for this chart: (2(ac + bd), 2(cd - ab), a^2 + d^2 - b^2 - c^2)
+            double x = 2 * (a * c + b * d);
+            double y = 2 * (c * d - a * b);
+            double z = a * a + d * d - b * b - c * c;
+            double dx = x - points[i][0], dy = y - points[i][1], dz = z - points[i][2];
+            forward.Add(sqrt(dx * dx + dy * dy + dz * dz) * weight, (long long)i);
+        }
+    }
+    failures += norm.Report() ? 0 : 1;
+    failures += forward.Report() ? 0 : 1;
+}
+
+// Circle through three points: center and radius, or false when they are (nearly) collinear
+static bool CircleThrough(const double* p0, const double* p1, const double* p2, double* center, double* normal, double& radius)
+{
+    double a[3], b[3], n[3];
+    for (int k = 0; k < 3; k++)
+    {
+        a[k] = p1[k] - p0[k];
+        b[k] = p2[k] - p0[k];
+    }
+    n[0] = a[1] * b[2] - a[2] * b[1];
+    n[1] = a[2] * b[0] - a[0] * b[2];
+    n[2] = a[0] * b[1] - a[1] * b[0];
+    double nn = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+    double aa = a[0] * a[0] + a[1] * a[1] + a[2] * a[2];
+    double bb = b[0] * b[0] + b[1] * b[1] + b[2] * b[2];
+    if (nn < 1e-12 * aa * bb)
+        return false;
+    // center = p0 + (|a|^2 (b x n) + |b|^2 (n x a)) / (2 |n|^2)
+    double bxn[3] = { b[1] * n[2] - b[2] * n[1], b[2] * n[0] - b[0] * n[2], b[0] * n[1] - b[1] * n[0] };
+    double nxa[3] = { n[1] * a[2] - n[2] * a[1], n[2] * a[0] - n[0] * a[2], n[0] * a[1] - n[1] * a[0] };
+    double length = sqrt(nn);
+    for (int k = 0; k < 3; k++)
+    {
+        center[k] = p0[k] + (aa * bxn[k] + bb * nxa[k]) / (2 * nn);
+        normal[k] = n[k] / length;
+    }
+    double dx = p0[0] - center[0], dy = p0[1] - center[1], dz = p0[2] - center[2];
+    radius = sqrt(dx * dx + dy * dy + dz * dz);
+    return true;
+}
+
+// Projection of the reference lift, in double; false for samples next to the projection pole
+static bool ProjectSample(const double* q, double* out)
+{
+    if (1 - q[3] < s_PoleDistance)
+        return false;
+    double s = FIBER_PROJECTION_SCALE / (1 - q[3]);
+    out[0] = q[0] * s;
+    out[1] = q[1] * s;
+    out[2] = q[2] * s;
+    return true;
+}
+
+static bool ReportHash(const std::string& name, uint64_t hash, uint64_t expected)
+{
+    bool pass = hash == expected;
+    printf("%s %-48s %016llx", pass ? "PASS" : "FAIL", name.c_str(), (unsigned long long)hash);
+    if (!pass)
+        printf(" (expected %016llx)", (unsigned long long)expected);
+    printf("\n");
+    return pass;
+}
+
+static void CheckKernel(const VerifyKernel& kernel, const std::vector<std::vector<double>>& points, double phiInc,
+                        uint64_t referenceHash, int& failures)
+{
+    FiberSet fiberSet;
+    kernel.build(points, fiberSet, phiInc);
+    unsigned int samplesPerFiber = GetFiberSampleCount(phiInc);
+    if (fiberSet.GetNumFibers() != points.size() || fiberSet.GetNumVertices() != points.size() * samplesPerFiber)
+    {
+        printf("FAIL %-48s built %u fibers, %zu vertices\n", (kernel.name + ": layout").c_str(), fiberSet.GetNumFibers(),
+            fiberSet.GetNumVertices());
+        failures++;
+        return;
+    }
+
+    VerifyCheck circle(kernel.name + ": projected fibers are circles", std::max(s_CircleTolerance, kernel.tolerance));
+    VerifyCheck agreement(kernel.name + ": agrees with LiftFiber + double projection", kernel.tolerance);
+    std::vector<double> samples;
+    std::vector<double> reference;
+    std::vector<char> valid;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        LiftFiber(points[i], phiInc, samples);
+        double weight = GetConditionWeight(points[i]);
+        unsigned int count = fiberSet.counts[i];
+        const float* vertices = &fiberSet.vertices[(size_t)fiberSet.firsts[i] * 3];
+        reference.assign(count * 3, 0.0);
+        valid.assign(count, 0);
+        for (unsigned int j = 0; j < count; j++)
+        {
+            valid[j] = ProjectSample(&samples[j * 4], &reference[j * 3]);
+            if (!valid[j])
+                continue;
+            double dx = vertices[j * 3] - reference[j * 3];
+            double dy = vertices[j * 3 + 1] - reference[j * 3 + 1];
+            double dz = vertices[j * 3 + 2] - reference[j * 3 + 2];
+            double magnitude = sqrt(reference[j * 3] * reference[j * 3] + reference[j * 3 + 1] * reference[j * 3 + 1]
+                + reference[j * 3 + 2] * reference[j * 3 + 2]);
+            double sampleWeight = weight * std::min(1.0, 1 - samples[j * 4 + 3]);
+            agreement.Add(sqrt(dx * dx + dy * dy + dz * dz) / std::max(magnitude, FIBER_PROJECTION_SCALE) * sampleWeight, (long long)i);
+        }
+
+        // Fit a circle through three well spread samples of the kernel's own output, then measure the rest
+        std::vector<unsigned int> picks;
+        for (unsigned int j = 0; j < count && picks.size() < 3; j += count / 3)
+        {
+            unsigned int k = j;
+            while (k < count && !valid[k])
+                k++;
+            if (k < count)
+                picks.push_back(k);
+        }
+        double p[3][3];
+        for (size_t k = 0; k < picks.size(); k++)
+        {
+            for (int c = 0; c < 3; c++)
+                p[k][c] = vertices[picks[k] * 3 + c];
+        }
+        double center[3], normal[3], radius;
+        if (picks.size() < 3 || !CircleThrough(p[0], p[1], p[2], center, normal, radius))
+            continue; //a fiber through the projection pole is a line
+        for (unsigned int j = 0; j < count; j++)
+        {
+            if (!valid[j])
+                continue;
+            double d[3] = { vertices[j * 3] - center[0], vertices[j * 3 + 1] - center[1], vertices[j * 3 + 2] - center[2] };
+            double height = d[0] * normal[0] + d[1] * normal[1] + d[2] * normal[2];
+            double distance = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+            double sampleWeight = weight * std::min(1.0, 1 - samples[j * 4 + 3]);
+            circle.Add(std::max(fabs(height), fabs(distance - radius)) / radius * sampleWeight, (long long)i);
+        }
+    }
+    failures += circle.Report() ? 0 : 1;
+    failures += agreement.Report() ? 0 : 1;
+
+    // The hashes taken while building must match hashing the finished buffers
+    FiberSetView rehashed = fiberSet.GetView();
+    rehashed.fiberHashes = nullptr;
+    uint64_t hash = fiberSet.GetContentHash();
+    failures += ReportHash(kernel.name + ": incremental hash", hash, GetFiberSetHash(rehashed)) ? 0 : 1;
+    if (kernel.exact)
+        failures += ReportHash(kernel.name + ": hash matches serial double", hash, referenceHash) ? 0 : 1;
+}
+
+// Golden content hashes of GenerateUniform(1000) at FIBER_PHI_STEP, recorded with glibc's libm on x86-64.
+// A change here means the numbers changed: check that it was intended and re-record from the FAIL line.
+static const uint64_t s_GoldenDoubleHash = 0x5f27abdebecf218cull;
+static const uint64_t s_GoldenFloatHash = 0x84f2b10699593c02ull;
+
+static void CheckHashes(int& failures)
+{
+    std::vector<std::vector<double>> points = GenerateUniform(1000);
+    FiberSet fiberSet;
+    BuildFiberSet(points, fiberSet, FIBER_PHI_STEP, FiberPrecision::Double);
+    uint64_t serial = fiberSet.GetContentHash();
+    failures += ReportHash("golden hash: uniform 1000 double", serial, s_GoldenDoubleHash) ? 0 : 1;
+    BuildFiberSet(points, fiberSet, FIBER_PHI_STEP, FiberPrecision::Float);
+    failures += ReportHash("golden hash: uniform 1000 float", fiberSet.GetContentHash(), s_GoldenFloatHash) ? 0 : 1;
+
+    // Every thread count has to give the serial result
+    unsigned int threadCounts[] = { 1, 2, 3, 8 };
+    for (size_t i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); i++)
+    {
+        ThreadPool pool(threadCounts[i]);
+        BuildFiberSet(points, fiberSet, FIBER_PHI_STEP, FiberPrecision::Double, pool);
+        std::string name = "hash with " + std::to_string(threadCounts[i]) + " thread" + (threadCounts[i] == 1 ? "" : "s");
+        failures += ReportHash(name, fiberSet.GetContentHash(), serial) ? 0 : 1;
+    }
+}
+
+// Hopf itself owns GL buffers, so it is only checked when a context can be created. Besides its lift,
+// the vertices the viewer actually draws go through CheckKernel like any FiberSet kernel.
+static void CheckHopf(const std::vector<std::vector<double>>& points, int& failures)
+{
+    HeadlessContext context;
+    if (!context.Create(3, 3))
+    {
+        printf("SKIP %-48s no OpenGL context\n", "Hopf::InverseHopfMap");
+        return;
+    }
+    std::vector<std::vector<double>> subset(points.begin(), points.begin() + std::min(points.size(), (size_t)1000));
+    VerifyCheck lift("Hopf::InverseHopfMap: matches LiftFiber", 0.0);
+    uint64_t hopfHash = 0;
+    {
+        Hopf hopf(&subset, false, 1.0f);
+        hopfHash = hopf.GetContentHash();
+        const std::vector<std::vector<std::vector<double>>>& circles = hopf.GetS3Circles();
+        std::vector<double> samples;
+        for (size_t i = 0; i < subset.size(); i++)
+        {
+            LiftFiber(subset[i], FIBER_PHI_STEP, samples);
+            if (circles[i].size() * 4 != samples.size())
+            {
+                lift.Add(1.0, (long long)i);
+                continue;
+            }
+            for (size_t j = 0; j < circles[i].size(); j++)
+            {
+                for (int k = 0; k < 4; k++)
+                    lift.Add(fabs(circles[i][j][k] - samples[j * 4 + k]), (long long)i);
+            }
+        }
+    }
+    failures += lift.Report() ? 0 : 1;
+
+    // The Status window shows Hopf's hash; it has to be the one hopf_cli prints for the same points
+    FiberSet fiberSet;
+    BuildFiberSet(subset, fiberSet, FIBER_PHI_STEP, FiberPrecision::Double);
+    uint64_t referenceHash = fiberSet.GetContentHash();
+    fiberSet.Clear();
+    failures += ReportHash("Hopf: content hash matches FiberSet", hopfHash, referenceHash) ? 0 : 1;
+
+    VerifyKernel kernel;
+    kernel.name = "Hopf::StereographicProjection";
+    kernel.tolerance = 1e-6;
+    kernel.exact = true;
+    kernel.build = [](const std::vector<std::vector<double>>& points, FiberSet& fiberSet, double /*phiInc*/) {
+        Hopf hopf(&points, false, 1.0f); //always samples at FIBER_PHI_STEP
+        hopf.GetFiberSet(fiberSet);
+    };
+    CheckKernel(kernel, subset, FIBER_PHI_STEP, referenceHash, failures);
+}
+
+int RunVerify(const VerifyOptions& options)
+{
+    std::vector<std::vector<double>> points = GenerateVerifyPoints(options);
+    printf("Verifying %zu base points, %u samples per fiber, seed %u\n", points.size(), GetFiberSampleCount(options.phiInc), options.seed);
+    int failures = 0;
+    CheckLifts(points, options.phiInc, failures);
+    FiberSet reference;
+    BuildFiberSet(points, reference, options.phiInc, FiberPrecision::Double);
+    uint64_t referenceHash = reference.GetContentHash();
+    reference.Clear();
+    std::vector<VerifyKernel> kernels = GetVerifyKernels();
+    for (size_t i = 0; i < kernels.size(); i++)
+    {
+        CheckKernel(kernels[i], points, options.phiInc, referenceHash, failures);
+    }
+    CheckHashes(failures);
+    if (options.useGL)
+        CheckHopf(points, failures);
+    printf("%d check%s failed\n", failures, failures == 1 ? "" : "s");
+    return failures;
+}
\ No newline at end of file
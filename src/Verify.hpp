@@ -0,0 +1,36 @@
+#pragma once
+
+#include "FiberSet.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Invariant checks for the fiber engine over many random base points:
+//   - every lifted sample lies on S3 (|q| = 1),
+//   - the Hopf map of every lifted sample is its base point,
+//   - every projected fiber is a circle,
+//   - every FiberSet kernel, and the vertices Hopf draws, agree with LiftFiber followed by the projection in double,
+//   - content hashes are independent of the thread count and match the recorded golden values.
+// A new fast path (SIMD, GPU, cached) gets checked by adding it to GetVerifyKernels.
+
+struct VerifyOptions
+{
+    int numPoints = 10000;          //random base points, plus a handful of fixed edge cases
+    unsigned int seed = 1;
+    double phiInc = FIBER_PHI_STEP;
+    bool useGL = true;              //also compare against Hopf itself (needs a headless context)
+};
+
+struct VerifyKernel
+{
+    std::string name;
+    std::function<void(const std::vector<std::vector<double>>& points, FiberSet& fiberSet, double phiInc)> build;
+    double tolerance;   //max error relative to the vertex magnitude (floored at FIBER_PROJECTION_SCALE)
+    bool exact;         //must reproduce the serial double build bit for bit (same content hash)
+};
+
+std::vector<VerifyKernel> GetVerifyKernels();
+
+// Prints one PASS/FAIL line per check and returns the number of failed checks
+int RunVerify(const VerifyOptions& options);
\ No newline at end of file
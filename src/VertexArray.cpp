@@ -1,6 +1,8 @@
 #include "VertexArray.hpp"
 #include "Renderer.hpp"
+#include "GLStats.hpp"
 #include "VertexBufferLayout.hpp"
+#include "StreamBuffer.hpp"
 #include <iostream>
 
 VertexArray::VertexArray()
@@ -10,20 +12,54 @@ VertexArray::VertexArray()
 
 VertexArray::~VertexArray() 
 {
-	
+	Delete();
 }
 
-void VertexArray::Delete() const
+VertexArray::VertexArray(VertexArray&& other) noexcept
+	: m_RendererID(other.m_RendererID)
 {
-	GLCall(glDeleteVertexArrays(1, &m_RendererID)); //delete the vertex array object
+	other.m_RendererID = 0;
+}
+
+VertexArray& VertexArray::operator=(VertexArray&& other) noexcept
+{
+	if (this != &other)
+	{
+		Delete();
+		m_RendererID = other.m_RendererID;
+		other.m_RendererID = 0;
+	}
+	return *this;
+}
+
+void VertexArray::Delete()
+{
+	if (m_RendererID)
+	{
+		GLCall(glDeleteVertexArrays(1, &m_RendererID)); //delete the vertex array object
+		m_RendererID = 0;
+	}
 }
 
 void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout, bool isInstance)
 {
 	Bind(); //bind the vertex array
 	vb.Bind(); //bind the vertex buffer
+	SetAttributes(layout, vb.GetOffset(), isInstance); //past the start of an arena range
+	vb.Unbind(); //unbind the vertex buffer
+}
+
+void VertexArray::AddBuffer(const StreamBuffer& sb, size_t offset, const VertexBufferLayout& layout, bool isInstance)
+{
+	Bind(); //bind the vertex array
+	sb.Bind(); //bind the stream buffer
+	SetAttributes(layout, offset, isInstance);
+	sb.Unbind(); //unbind the stream buffer
+}
+
+void VertexArray::SetAttributes(const VertexBufferLayout& layout, size_t offset, bool isInstance)
+{
 	const auto& elements = layout.GetElements(); //get the elements of the layout
-	unsigned int offset = 0; //offset of the vertex
 	for (unsigned int i = 0; i < elements.size(); i++)
 	{
 		const auto& element = elements[i];
@@ -33,13 +69,13 @@ void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& la
 		{
 			GLCall(glVertexAttribDivisor(i, 1));
 		}
-		offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
+		offset += VertexBufferElement::GetSize(element.type, element.count);
 	}
-	vb.Unbind(); //unbind the vertex buffer
 }
 
 void VertexArray::Bind() const
 {
+	GLStats::CountVaoBind();
 	GLCall(glBindVertexArray(m_RendererID));
 }
 void VertexArray::Unbind() const
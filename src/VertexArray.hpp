@@ -3,18 +3,28 @@
 #include <string>
 
 class VertexBufferLayout;
+class StreamBuffer;
 
+// Owns its GL vertex array: move-only, deleted in the destructor
 class VertexArray
 {
 public:
 	VertexArray();
 	~VertexArray();
+	VertexArray(VertexArray&& other) noexcept;
+	VertexArray& operator=(VertexArray&& other) noexcept;
+	VertexArray(const VertexArray&) = delete;
+	VertexArray& operator=(const VertexArray&) = delete;
 
 	void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout, bool isInstance);
-	void Delete() const;
+	// Points the attributes at the region of a stream buffer that starts at offset (from StreamBuffer::Write)
+	void AddBuffer(const StreamBuffer& sb, size_t offset, const VertexBufferLayout& layout, bool isInstance);
+	void Delete(); //releases the vertex array early; safe to call more than once
 	void Bind() const;
 	void Unbind() const;
 
 private:
-	unsigned int m_RendererID;
+	void SetAttributes(const VertexBufferLayout& layout, size_t offset, bool isInstance);
+
+	unsigned int m_RendererID = 0;
 };
\ No newline at end of file
@@ -1,28 +1,96 @@
 #include "VertexBuffer.hpp"
 #include "Renderer.hpp"
+#include "Profiler.hpp"
+#include "GLStats.hpp"
 #include <iostream>
 
 VertexBuffer::VertexBuffer(const void* data, unsigned int size)
+    : m_Size(size)
 {
+    PROFILE_SCOPE("VertexBuffer upload");
     GLCall(glGenBuffers(1, &m_RendererID));   //generate 1 buffer, store it in buffer
     GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));  //GL_ARRAY_BUFFER is a type of buffer, bind the current buffer
     GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW)); //6 * sizeof(float) is the size of the data we are storing
+    GLStats::CountUpload(size);
 }
 
-void VertexBuffer::UpdateData(const void* data, unsigned int size)
+VertexBuffer::VertexBuffer(const void* data, unsigned int size, BufferArena& arena)
+    : m_Arena(&arena)
 {
+    PROFILE_SCOPE("VertexBuffer upload");
+    m_Range = arena.Allocate(size);
+    m_RendererID = m_Range.buffer;
+    arena.Upload(m_Range, data, size);
+}
+
+bool VertexBuffer::UpdateData(const void* data, unsigned int size)
+{
+    PROFILE_SCOPE("VertexBuffer::UpdateData");
+    if (m_Arena)
+    {
+        if (size <= m_Range.size && m_Range.block >= 0)
+        {
+            m_Arena->Upload(m_Range, data, size);
+            return false;
+        }
+        // Take the new range before giving back the old one, so a lone range does not release its block
+        BufferRange range = m_Arena->Allocate(size);
+        m_Arena->Upload(range, data, size);
+        m_Arena->Free(m_Range);
+        m_Range = range;
+        m_RendererID = m_Range.buffer;
+        return true;
+    }
+    // Rewrite in place when the data fits; only growing respecifies the storage. Data that changes
+    // every frame belongs in a StreamBuffer.
     Bind();
-    GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW)); //6 * sizeof(float) is the size of the data we are storing
+    if (size <= m_Size)
+    {
+        GLCall(glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
+    }
+    else
+    {
+        GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW));
+        m_Size = size;
+    }
+    GLStats::CountUpload(size);
+    return false;
 }
 
-/*
 VertexBuffer::~VertexBuffer()
 {
-    GLCall(glDeleteBuffers(1, &m_RendererID));	//delete the buffer
-}*/
+    Delete();
+}
+
+VertexBuffer::VertexBuffer(VertexBuffer&& other) noexcept
+    : m_RendererID(other.m_RendererID), m_Size(other.m_Size), m_Range(other.m_Range), m_Arena(other.m_Arena)
+{
+    other.m_RendererID = 0;
+    other.m_Size = 0;
+    other.m_Range = BufferRange();
+    other.m_Arena = nullptr;
+}
+
+VertexBuffer& VertexBuffer::operator=(VertexBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        Delete();
+        m_RendererID = other.m_RendererID;
+        m_Size = other.m_Size;
+        m_Range = other.m_Range;
+        m_Arena = other.m_Arena;
+        other.m_RendererID = 0;
+        other.m_Size = 0;
+        other.m_Range = BufferRange();
+        other.m_Arena = nullptr;
+    }
+    return *this;
+}
 
 void VertexBuffer::Bind() const
 {
+    GLStats::CountBufferBind();
     GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));  //GL_ARRAY_BUFFER is a type of buffer, bind the current buffer
 }
 void VertexBuffer::Unbind() const
@@ -30,7 +98,16 @@ void VertexBuffer::Unbind() const
     GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));  //GL_ARRAY_BUFFER is a type of buffer, bind the current buffer
 }
 
-void VertexBuffer::Delete() const
+void VertexBuffer::Delete()
 {
-    GLCall(glDeleteBuffers(1, &m_RendererID));	//delete the buffer
+    if (m_Arena)
+    {
+        m_Arena->Free(m_Range);
+        m_RendererID = 0;
+    }
+    else if (m_RendererID)
+    {
+        GLCall(glDeleteBuffers(1, &m_RendererID));	//delete the buffer
+        m_RendererID = 0;
+    }
 }
\ No newline at end of file
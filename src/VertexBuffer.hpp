@@ -2,16 +2,31 @@
 
 #include <glm/glm.hpp>
 
+#include "BufferArena.hpp"
+
+// Owns its GL buffer, or a range of a BufferArena block: move-only, released in the destructor
 class VertexBuffer
 {
 public:
 	VertexBuffer() : m_RendererID(0) {}; //Default constructor
 	VertexBuffer(const void* data, unsigned int size); //constructor
+	VertexBuffer(const void* data, unsigned int size, BufferArena& arena); //range of a shared arena block
+	~VertexBuffer();
+	VertexBuffer(VertexBuffer&& other) noexcept;
+	VertexBuffer& operator=(VertexBuffer&& other) noexcept;
+	VertexBuffer(const VertexBuffer&) = delete;
+	VertexBuffer& operator=(const VertexBuffer&) = delete;
 
-	void UpdateData(const void* data, unsigned int size);
+	// Returns true when an arena range had to move to fit the data; vertex arrays must then be re-pointed (AddBuffer)
+	bool UpdateData(const void* data, unsigned int size);
 	void Bind() const;
 	void Unbind() const;
-	void Delete() const;
+	void Delete(); //releases the buffer early; safe to call more than once
+
+	inline unsigned int GetOffset() const { return m_Range.offset; } //byte offset of the data in the bound buffer
 private:
 	unsigned int m_RendererID = 0;
+	unsigned int m_Size = 0;        //bytes of storage, for buffers of their own
+	BufferRange m_Range;            //block >= 0 when the data lives in an arena
+	BufferArena* m_Arena = nullptr;
 };
\ No newline at end of file
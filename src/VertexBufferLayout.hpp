@@ -2,6 +2,7 @@
 #include <vector>
 #include <GL/glew.h>
 #include "Renderer.hpp"
+#include "VertexFormat.hpp"
 
 struct VertexBufferElement
 {
@@ -12,11 +13,21 @@ struct VertexBufferElement
 		case GL_FLOAT:			return sizeof(GLfloat);
 		case GL_UNSIGNED_INT:	return sizeof(GLuint);
 		case GL_UNSIGNED_BYTE:	return sizeof(GLubyte);
+		case GL_SHORT:			return sizeof(GLshort);
+		case GL_HALF_FLOAT:		return sizeof(GLhalf);
 		}
 		ASSERT(false);
 		return 0;
 	}
 
+	// Bytes of one attribute; the packed types hold all four components in one 32-bit word
+	static unsigned int GetSize(unsigned int type, unsigned int count)
+	{
+		if (type == GL_UNSIGNED_INT_2_10_10_10_REV || type == GL_INT_2_10_10_10_REV)
+			return sizeof(GLuint);
+		return count * GetSizeOfType(type);
+	}
+
 	VertexBufferElement(unsigned int t, unsigned int c, bool n) :
 		count(c), type(t), normalized(n)
 	{
@@ -33,10 +44,6 @@ public:
 		: m_Stride(0)
 	{
 
-	}
-	~VertexBufferLayout()
-	{
-
 	}
 
 	template<typename T>
@@ -45,30 +52,52 @@ public:
 		ASSERT(false);
 	}
 
-	template<>
-	void Push<float>(unsigned int count)
-	{
-		m_Elements.push_back(VertexBufferElement({ GL_FLOAT, count, GL_FALSE }));
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
-	}
-
-	template<>
-	void Push<unsigned int>(unsigned int  count)
-	{
-		m_Elements.push_back(VertexBufferElement({ GL_UNSIGNED_INT, count, GL_FALSE }));
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
-	}
-
-	template<>
-	void Push<unsigned char>(unsigned int  count)
-	{
-		m_Elements.push_back(VertexBufferElement({ GL_UNSIGNED_BYTE, count, GL_TRUE }));
-		m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
-	}
-
 	inline unsigned int GetStride() const { return m_Stride; }
 	inline const std::vector<VertexBufferElement> GetElements() const { return m_Elements; }
 private:
 	std::vector<VertexBufferElement> m_Elements;
 	unsigned int m_Stride;
-};
\ No newline at end of file
+};
+
+template<>
+inline void VertexBufferLayout::Push<float>(unsigned int count)
+{
+	m_Elements.push_back(VertexBufferElement({ GL_FLOAT, count, GL_FALSE }));
+	m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned int>(unsigned int  count)
+{
+	m_Elements.push_back(VertexBufferElement({ GL_UNSIGNED_INT, count, GL_FALSE }));
+	m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned char>(unsigned int  count)
+{
+	m_Elements.push_back(VertexBufferElement({ GL_UNSIGNED_BYTE, count, GL_TRUE }));
+	m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+}
+
+template<>
+inline void VertexBufferLayout::Push<short>(unsigned int count)
+{
+	m_Elements.push_back(VertexBufferElement({ GL_SHORT, count, GL_TRUE })); //snorm16, read as [-1, 1]
+	m_Stride += count * VertexBufferElement::GetSizeOfType(GL_SHORT);
+}
+
+template<>
+inline void VertexBufferLayout::Push<HalfFloat>(unsigned int count)
+{
+	m_Elements.push_back(VertexBufferElement({ GL_HALF_FLOAT, count, GL_FALSE }));
+	m_Stride += count * VertexBufferElement::GetSizeOfType(GL_HALF_FLOAT);
+}
+
+template<>
+inline void VertexBufferLayout::Push<PackedUnorm1010102>(unsigned int count)
+{
+	ASSERT(count == 4); //rgb in 10 bits each, alpha in 2
+	m_Elements.push_back(VertexBufferElement({ GL_UNSIGNED_INT_2_10_10_10_REV, count, GL_TRUE }));
+	m_Stride += VertexBufferElement::GetSize(GL_UNSIGNED_INT_2_10_10_10_REV, count);
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "VertexFormat.hpp"
+
+#include <cmath>
+#include <cstring>
+
+const char* GetVertexFormatName(VertexFormat format)
+{
+    switch (format)
+    {
+    case VertexFormat::Float32: return "float";
+    case VertexFormat::Half:    return "half";
+    case VertexFormat::Snorm16: return "snorm16";
+    }
+    return "float";
+}
+
+bool ParseVertexFormat(const std::string& name, VertexFormat& format)
+{
+    if (name == "float")
+        format = VertexFormat::Float32;
+    else if (name == "half")
+        format = VertexFormat::Half;
+    else if (name == "snorm16")
+        format = VertexFormat::Snorm16;
+    else
+        return false;
+    return true;
+}
+
+uint16_t FloatToHalf(float value)
+{
+    uint32_t f;
+    memcpy(&f, &value, sizeof(f));
+    uint32_t sign = (f >> 16) & 0x8000;
+    uint32_t exponent = (f >> 23) & 0xff;
+    uint32_t mantissa = f & 0x7fffff;
+
+    if (exponent == 0xff) //inf or nan, keeping nans quiet
+        return (uint16_t)(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+    int e = (int)exponent - 127 + 15;
+    if (e >= 31)
+        return (uint16_t)(sign | 0x7c00);
+    if (e <= 0)
+    {   //subnormal half, or zero
+        if (e < -10)
+            return (uint16_t)sign;
+        mantissa |= 0x800000;
+        int shift = 14 - e;
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1)))
+            half++;
+        return (uint16_t)(sign | half);
+    }
+    uint32_t half = ((uint32_t)e << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1fff;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+        half++; //may carry into the exponent, which rounds up to the next power of two or infinity
+    return (uint16_t)(sign | half);
+}
+
+float HalfToFloat(uint16_t bits)
+{
+    uint32_t sign = (uint32_t)(bits & 0x8000) << 16;
+    uint32_t exponent = (bits >> 10) & 0x1f;
+    uint32_t mantissa = bits & 0x3ff;
+    uint32_t f;
+    if (exponent == 0x1f)
+        f = sign | 0x7f800000 | (mantissa << 13);
+    else if (exponent != 0)
+        f = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    else
+    {
+        float value = std::ldexp((float)mantissa, -24);
+        return sign ? -value : value;
+    }
+    float value;
+    memcpy(&value, &f, sizeof(value));
+    return value;
+}
+
+int16_t QuantizeSnorm16(float value, float minimum, float maximum)
+{
+    float extent = maximum - minimum;
+    float t = extent > 0.0f ? (value - minimum) / extent * 2.0f - 1.0f : 0.0f; //-1..1 over the bounds
+    float scaled = t * 32767.0f;
+    scaled = scaled < -32767.0f ? -32767.0f : (scaled > 32767.0f ? 32767.0f : scaled);
+    return (int16_t)lrintf(scaled);
+}
+
+float DequantizeSnorm16(int16_t value, float minimum, float maximum)
+{
+    float t = value / 32767.0f;
+    return minimum + (t + 1.0f) * 0.5f * (maximum - minimum);
+}
+
+static inline uint32_t PackUnorm(float c, float maximum)
+{
+    c = c < 0.0f ? 0.0f : (c > 1.0f ? 1.0f : c);
+    return (uint32_t)(c * maximum + 0.5f);
+}
+
+uint32_t PackUnorm1010102(float r, float g, float b, float a)
+{
+    return PackUnorm(r, 1023.0f) | (PackUnorm(g, 1023.0f) << 10) | (PackUnorm(b, 1023.0f) << 20) | (PackUnorm(a, 3.0f) << 30);
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Storage format of the positions in the fiber and point buffers
+enum class VertexFormat
+{
+    Float32,    //three floats
+    Half,       //four IEEE half floats, w = 1
+    Snorm16     //four normalized shorts, mapped onto per-fiber bounds (Hopf) or the preview sphere (Points)
+};
+
+// Attribute types for VertexBufferLayout::Push beyond the plain C++ ones
+struct HalfFloat
+{
+    uint16_t bits;
+};
+
+struct PackedUnorm1010102 //GL_UNSIGNED_INT_2_10_10_10_REV, r in the low bits
+{
+    uint32_t bits;
+};
+
+const char* GetVertexFormatName(VertexFormat format);
+bool ParseVertexFormat(const std::string& name, VertexFormat& format); //float, half or snorm16
+
+uint16_t FloatToHalf(float value); //round to nearest even, saturates to infinity
+float HalfToFloat(uint16_t bits);
+int16_t QuantizeSnorm16(float value, float minimum, float maximum); //-32767..32767 over [minimum, maximum]
+float DequantizeSnorm16(int16_t value, float minimum, float maximum);
+uint32_t PackUnorm1010102(float r, float g, float b, float a);
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "PerfCounters.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static int OpenCounter(unsigned long long config, int groupFd)
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = groupFd < 0 ? 1 : 0; //members follow the leader
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+#endif
+
+PerfCounters::PerfCounters()
+    : m_GroupFd(-1)
+{
+    for (int i = 0; i < 4; i++)
+        m_Fds[i] = -1;
+}
+
+PerfCounters::~PerfCounters()
+{
+    Close();
+}
+
+bool PerfCounters::Open()
+{
+#ifdef __linux__
+    static const unsigned long long configs[4] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+    for (int i = 0; i < 4; i++)
+    {
+        m_Fds[i] = OpenCounter(configs[i], i == 0 ? -1 : m_Fds[0]);
+        if (m_Fds[i] < 0)
+        {
+            printf("perf_event_open failed for counter %d; check /proc/sys/kernel/perf_event_paranoid\n", i);
+            Close();
+            return false;
+        }
+    }
+    m_GroupFd = m_Fds[0];
+    return true;
+#else
+    printf("Hardware counters need Linux perf_event_open\n");
+    return false;
+#endif
+}
+
+void PerfCounters::Start()
+{
+#ifdef __linux__
+    if (m_GroupFd < 0)
+        return;
+    ioctl(m_GroupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(m_GroupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+PerfSample PerfCounters::Stop()
+{
+    PerfSample sample;
+#ifdef __linux__
+    if (m_GroupFd < 0)
+        return sample;
+    ioctl(m_GroupFd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    unsigned long long values[1 + 4]; //PERF_FORMAT_GROUP: nr, then one value per counter
+    if (read(m_GroupFd, values, sizeof(values)) != (ssize_t)sizeof(values) || values[0] != 4)
+        return sample;
+    sample.cycles = values[1];
+    sample.instructions = values[2];
+    sample.cacheMisses = values[3];
+    sample.branchMisses = values[4];
+    sample.valid = true;
+#endif
+    return sample;
+}
+
+void PerfCounters::Close()
+{
+#ifdef __linux__
+    for (int i = 3; i >= 0; i--)
+    {
+        if (m_Fds[i] >= 0)
+            close(m_Fds[i]);
+        m_Fds[i] = -1;
+    }
+#endif
+    m_GroupFd = -1;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+// Hardware counters for one thread via Linux perf_event_open, read as a group so the numbers cover
+// the same instructions. Elsewhere, or when the kernel refuses (perf_event_paranoid, containers),
+// Open() returns false and the harness prints timings only.
+struct PerfSample
+{
+    unsigned long long cycles = 0;
+    unsigned long long instructions = 0;
+    unsigned long long cacheMisses = 0;
+    unsigned long long branchMisses = 0;
+    bool valid = false;
+};
+
+class PerfCounters
+{
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    bool Open();
+    bool IsOpen() const { return m_GroupFd >= 0; }
+    void Start();   //resets and enables the group
+    PerfSample Stop();
+
+private:
+    PerfCounters(const PerfCounters&);
+    PerfCounters& operator=(const PerfCounters&);
+
+    void Close();
+
+    int m_GroupFd;
+    int m_Fds[4];   //cycles (leader), instructions, cache misses, branch misses
+};
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include "Sweep.hpp"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Camera.hpp"
+#include "FiberSet.hpp"
+#include "FrameBuffer.hpp"
+#include "GlobalFunctions.hpp"
+#include "Headless.hpp"
+#include "ProcessStats.hpp"
+#include "Scene.hpp"
+#include "ThreadPool.hpp"
+#include "VertexBuffer.hpp"
+
+struct SweepOptions
+{
+    int maxFibers = 1000000;
+    int stepsPerDecade = 2;         //1, 3, 10, 30, ... (sqrt(10) spacing)
+    int ringSize = 315;             //samples per fiber, 315 = FIBER_PHI_STEP
+    unsigned int maxThreads = 0;    //0 = hardware threads
+    int glMaxFibers = 1000000;      //skip upload and draw above this count, or above Hopf::MaxBufferBytes of vertices
+    int frames = 10;                //frames averaged for the draw stage
+    std::string csv = "sweep.csv";
+};
+
+struct SweepRow
+{
+    int fibers;
+    const char* stage;
+    unsigned int threads;
+    double seconds;
+    size_t vertices;
+    size_t residentBytes;
+    size_t peakResidentBytes;
+};
+
+static double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool ParseSweepOptions(int argc, char** argv, SweepOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--sweep")
+            continue;
+        else if (arg == "--max-fibers" && hasValue)
+            options.maxFibers = atoi(argv[++i]);
+        else if (arg == "--steps-per-decade" && hasValue)
+            options.stepsPerDecade = std::max(1, atoi(argv[++i]));
+        else if (arg == "--ring" && hasValue)
+            options.ringSize = atoi(argv[++i]);
+        else if (arg == "--threads" && hasValue)
+            options.maxThreads = (unsigned int)atoi(argv[++i]);
+        else if (arg == "--gl-max-fibers" && hasValue)
+            options.glMaxFibers = atoi(argv[++i]);
+        else if (arg == "--frames" && hasValue)
+            options.frames = std::max(1, atoi(argv[++i]));
+        else if (arg == "--csv" && hasValue)
+            options.csv = argv[++i];
+        else
+        {
+            printf("Usage: hopf_bench --sweep [--max-fibers N] [--steps-per-decade K] [--ring samples] [--threads N]"
+                   " [--gl-max-fibers N] [--frames N] [--csv sweep.csv]\n");
+            return false;
+        }
+    }
+    return options.maxFibers > 0 && options.ringSize >= 3;
+}
+
+// Lift and projection kept as separate passes (the way Hopf runs them) over a reused chunk buffer,
+// so each stage can be timed on its own at any fiber count without holding every S3 point at once
+static void LiftChunk(const std::vector<std::vector<double>>& points, size_t begin, size_t end,
+                      const std::vector<double>& phis, std::vector<double>& s3)
+{
+    size_t samples = phis.size();
+    s3.resize((end - begin) * samples * 4);
+    double* out = &s3[0];
+    for (size_t i = begin; i < end; i++)
+    {
+        double x = points[i][0];
+        double y = points[i][1];
+        double z = points[i][2];
+        double f = 1 / sqrt(2 * (1 + z));
+        for (size_t j = 0; j < samples; j++)
+        {
+            double phi = phis[j];
+            *out++ = cos(phi) * (1 + z) * f;
+            *out++ = (sin(phi) * x - cos(phi) * y) * f;
+            *out++ = (cos(phi) * x + sin(phi) * y) * f;
+            *out++ = sin(phi) * (1 + z) * f;
+        }
+    }
+}
+
+static void ProjectChunk(const std::vector<double>& s3, std::vector<float>& r3)
+{
+    size_t numVertices = s3.size() / 4;
+    r3.resize(numVertices * 3);
+    for (size_t v = 0; v < numVertices; v++)
+    {
+        double s = FIBER_PROJECTION_SCALE / (1 - s3[v * 4 + 3]);
+        r3[v * 3 + 0] = (float)(s3[v * 4 + 0] * s);
+        r3[v * 3 + 1] = (float)(s3[v * 4 + 1] * s);
+        r3[v * 3 + 2] = (float)(s3[v * 4 + 2] * s);
+    }
+}
+
+int RunSweep(int argc, char** argv)
+{
+    SweepOptions options;
+    if (!ParseSweepOptions(argc, argv, options))
+        return -1;
+
+    double phiInc = 2 * PI / (options.ringSize - 0.5);
+    std::vector<double> phis;
+    for (double phi = 0; phi <= 2 * PI; phi += phiInc)
+        phis.push_back(phi);
+    unsigned int samples = (unsigned int)phis.size();
+
+    unsigned int maxThreads = options.maxThreads > 0 ? options.maxThreads : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int t = 1; t < maxThreads; t *= 2)
+        threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    std::vector<int> fiberCounts;
+    for (int k = 0;; k++)
+    {
+        int n = (int)floor(pow(10.0, (double)k / options.stepsPerDecade) + 0.5);
+        if (n > options.maxFibers)
+            break;
+        if (fiberCounts.empty() || n != fiberCounts.back())
+            fiberCounts.push_back(n);
+    }
+
+    HeadlessContext context;
+    bool hasGL = context.Create(4, 1);
+    if (!hasGL)
+        printf("No OpenGL context; upload and draw stages are skipped\n");
+
+    FILE* csv = fopen(options.csv.c_str(), "w");
+    if (!csv)
+    {
+        printf("Could not open %s\n", options.csv.c_str());
+        return -1;
+    }
+    fprintf(csv, "fibers,stage,threads,seconds,vertices,ns_per_vertex,resident_bytes,peak_resident_bytes\n");
+
+    printf("%8s %10s %10s %10s %10s %10s %10s %10s %10s %10s\n",
+        "fibers", "generate", "lift", "project", "color", "build", "upload", "hopf", "draw", "rss_mb");
+
+    std::vector<SweepRow> rows;
+    // Samples memory as each stage finishes, so every row shows what was resident after its stage
+    auto addRow = [&rows](int fibers, const char* stage, unsigned int threads, double seconds, size_t vertices)
+    {
+        size_t resident = GetCurrentResidentBytes();
+        rows.push_back({ fibers, stage, threads, seconds, vertices, resident, std::max(GetPeakResidentBytes(), resident) });
+    };
+    for (size_t f = 0; f < fiberCounts.size(); f++)
+    {
+        int n = fiberCounts[f];
+        size_t numVertices = (size_t)n * samples;
+        rows.clear();
+        std::chrono::steady_clock::time_point start;
+
+        start = std::chrono::steady_clock::now();
+        std::vector<std::vector<double>> points = GenerateUniform(n);
+        addRow(n, "generate", 1, SecondsSince(start), (size_t)n);
+
+        {
+            const size_t chunkFibers = 256;
+            std::vector<double> s3;
+            std::vector<float> r3;
+            double liftSeconds = 0.0, projectSeconds = 0.0;
+            for (size_t begin = 0; begin < points.size(); begin += chunkFibers)
+            {
+                size_t end = std::min(begin + chunkFibers, points.size());
+                start = std::chrono::steady_clock::now();
+                LiftChunk(points, begin, end, phis, s3);
+                liftSeconds += SecondsSince(start);
+                start = std::chrono::steady_clock::now();
+                ProjectChunk(s3, r3);
+                projectSeconds += SecondsSince(start);
+            }
+            addRow(n, "lift", 1, liftSeconds, numVertices);
+            addRow(n, "project", 1, projectSeconds, numVertices);
+        }
+
+        start = std::chrono::steady_clock::now();
+        std::vector<std::vector<double>> colors(points.size());
+        for (size_t i = 0; i < points.size(); i++)
+            colors[i] = GetColor(points[i]);
+        addRow(n, "color", 1, SecondsSince(start), (size_t)n);
+
+        // Fused lift + project + color across threads; the set built last is what gets uploaded
+        FiberSet fiberSet;
+        for (size_t t = 0; t < threadCounts.size(); t++)
+        {
+            ThreadPool pool(threadCounts[t]);
+            start = std::chrono::steady_clock::now();
+            BuildFiberSet(points, fiberSet, phiInc, FiberPrecision::Double, pool);
+            addRow(n, "build", threadCounts[t], SecondsSince(start), numVertices);
+        }
+
+        // The stored set uploads as 12 bytes per vertex; sizes stay in size_t so large rings cannot wrap
+        size_t glBytes = fiberSet.vertices.size() * sizeof(float);
+        if (hasGL && n <= options.glMaxFibers && glBytes > Hopf::MaxBufferBytes)
+        {
+            fprintf(stderr, "%d fibers: %zu bytes of vertices exceed the GL buffer limit, skipping upload and draw\n", n, glBytes);
+        }
+        else if (hasGL && n <= options.glMaxFibers)
+        {
+            Renderer renderer;
+            Shader shader("res/shaders/Basic.shader");
+            Shader fiberShader("res/shaders/Fiber.shader");
+            Axis axis(10000.0f);
+            Plane plane(10000.0f, 10000.0f);
+            Camera camera(45.0f, 1920.0f / 1080.0f, 0.1f, 50000.0f, nullptr, false);
+            camera.SetPosition(glm::vec3(0, 50.0f, 0.0));
+            SceneOptions sceneOptions;
+
+            FrameBuffer fbo;
+            fbo.AttachTexture(1920, 1080);
+            fbo.AttachDepthBuffer();
+            fbo.Bind();
+            ConfigureRenderState(1920, 1080);
+
+            // The GL upload of the vertex data on its own, then the whole Hopf (hashing, colors and upload)
+            {
+                GLCall(glFinish());
+                start = std::chrono::steady_clock::now();
+                VertexBuffer vbo(fiberSet.vertices.data(), (unsigned int)glBytes);
+                GLCall(glFinish());
+                addRow(n, "upload", 1, SecondsSince(start), numVertices);
+            }
+            std::vector<Hopf> hopfs;
+            GLCall(glFinish());
+            start = std::chrono::steady_clock::now();
+            hopfs.push_back(Hopf(fiberSet.GetView(), false, 1.0f));
+            GLCall(glFinish());
+            addRow(n, "hopf", 1, SecondsSince(start), numVertices);
+
+            DrawScene(renderer, shader, fiberShader, axis, plane, hopfs, camera.GetViewMatrix(), camera.GetProjectionMatrix(), sceneOptions);
+            GLCall(glFinish());
+            start = std::chrono::steady_clock::now();
+            for (int frame = 0; frame < options.frames; frame++)
+            {
+                DrawScene(renderer, shader, fiberShader, axis, plane, hopfs, camera.GetViewMatrix(), camera.GetProjectionMatrix(), sceneOptions);
+                GLCall(glFinish());
+            }
+            addRow(n, "draw", 1, SecondsSince(start) / options.frames, numVertices);
+
+            fbo.Unbind();
+            fbo.Delete();
+        }
+
+        double stageMs[8] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+        const char* stages[8] = { "generate", "lift", "project", "color", "build", "upload", "hopf", "draw" };
+        for (size_t r = 0; r < rows.size(); r++)
+        {
+            const SweepRow& row = rows[r];
+            fprintf(csv, "%d,%s,%u,%.9f,%zu,%.4f,%zu,%zu\n", row.fibers, row.stage, row.threads, row.seconds, row.vertices,
+                row.seconds * 1e9 / row.vertices, row.residentBytes, row.peakResidentBytes);
+            for (int s = 0; s < 8; s++)
+            {
+                // The summary shows the single-threaded build; the CSV has every thread count
+                if (std::string(row.stage) == stages[s] && row.threads == 1)
+                    stageMs[s] = row.seconds * 1e3;
+            }
+        }
+        fflush(csv);
+
+        printf("%8d", n);
+        for (int s = 0; s < 8; s++)
+        {
+            if (stageMs[s] < 0)
+                printf(" %10s", "-");
+            else
+                printf(" %10.3f", stageMs[s]);
+        }
+        printf(" %10.1f\n", rows.empty() ? 0.0 : rows.back().residentBytes / (1024.0 * 1024.0)); //after the last stage
+        fflush(stdout);
+    }
+    printf("Stage times in ms; per-thread build times and ns/vertex are in %s\n", options.csv.c_str());
+    return fclose(csv) == 0 ? 0 : -1;
+}
\ No newline at end of file
@@ -0,0 +1,6 @@
+#pragma once
+
+// hopf_bench --sweep: fiber counts from 1 to 1M on a log scale, timing each pipeline stage
+// (generation, lift, project, color, upload, draw), memory and thread scaling of the FiberSet build.
+// Writes one CSV row per (fiber count, stage, thread count).
+int RunSweep(int argc, char** argv);
\ No newline at end of file
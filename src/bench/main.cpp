@@ -0,0 +1,332 @@
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "FiberSet.hpp"
+#include "GlobalFunctions.hpp"
+#include "Headless.hpp"
+#include "render_geom/Hopf/Hopf.hpp"
+#include "render_geom/Points/Points.hpp"
+#include "Sweep.hpp"
+#include "PerfCounters.hpp"
+#include "AllocationTracker.hpp"
+#include "GLStats.hpp"
+#include "Shader.hpp"
+
+// Microbenchmarks for the fiber math. Every kernel is timed over a grid of fiber counts (and ring sizes
+// where the kernel takes one) and reported as ns per produced vertex, so runs before and after a change
+// can be compared line by line.
+
+struct BenchOptions
+{
+    std::vector<int> fiberCounts = { 100, 1000, 10000 };
+    std::vector<int> ringSizes = { 64, 315, 1024 };  //samples per fiber
+    double minSeconds = 0.2;    //each measurement repeats the kernel until this much time has passed
+    int samples = 5;            //measurements per case; the fastest one is reported
+    std::string filter;         //only run benchmarks whose name contains this
+    std::string csv;            //also write the results here
+    bool perf = false;          //collect hardware counters over one extra measurement per case
+};
+
+struct BenchResult
+{
+    std::string name;
+    int fibers;
+    int ringSize;
+    size_t vertices;            //elements produced by one call
+    long long iterations;
+    double secondsPerCall;
+    AllocationStats allocationsPerCall; //zero unless built with HOPF_TRACK_ALLOCATIONS
+    GLCounters glPerCall;               //zero for kernels that do not touch GL
+    PerfSample perf;                    //totals over perfIterations calls, valid only with --perf
+    long long perfIterations;
+};
+
+// Phi step that yields exactly ringSize samples in the kernels' phi <= 2pi loop
+static double GetPhiStep(int ringSize)
+{
+    return 2 * PI / (ringSize - 0.5);
+}
+
+static double MeasureOnce(const std::function<void()>& kernel, double minSeconds, long long& iterations)
+{
+    iterations = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    do
+    {
+        kernel();
+        iterations++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < minSeconds);
+    return elapsed / iterations;
+}
+
+class BenchRunner
+{
+public:
+    explicit BenchRunner(const BenchOptions& options) : m_Options(options)
+    {
+        if (m_Options.perf && !m_Counters.Open())
+            m_Options.perf = false;
+    }
+
+    bool HasPerf() const { return m_Options.perf; }
+
+    bool IsEnabled(const std::string& name) const
+    {
+        return m_Options.filter.empty() || name.find(m_Options.filter) != std::string::npos;
+    }
+
+    void Run(const std::string& name, int fibers, int ringSize, size_t vertices, const std::function<void()>& kernel)
+    {
+        kernel(); //warm caches and allocator pools
+        BenchResult result;
+        result.name = name;
+        result.fibers = fibers;
+        result.ringSize = ringSize;
+        result.vertices = vertices;
+        result.iterations = 0;
+        result.secondsPerCall = 1e30;
+        result.perfIterations = 0;
+        AllocationStats before = AllocationTracker::GetThreadTotal();
+        GLCounters glBefore = GLStats::GetTotal();
+        kernel();
+        AllocationStats after = AllocationTracker::GetThreadTotal();
+        result.glPerCall = GLStats::Difference(GLStats::GetTotal(), glBefore);
+        result.allocationsPerCall.allocations = after.allocations - before.allocations;
+        result.allocationsPerCall.bytes = after.bytes - before.bytes;
+        for (int i = 0; i < m_Options.samples; i++)
+        {
+            long long iterations;
+            double seconds = MeasureOnce(kernel, m_Options.minSeconds / m_Options.samples, iterations);
+            if (seconds < result.secondsPerCall)
+            {
+                result.secondsPerCall = seconds;
+                result.iterations = iterations;
+            }
+        }
+        if (m_Options.perf)
+        {   //separate run so the counter syscalls stay out of the timings
+            m_Counters.Start();
+            MeasureOnce(kernel, m_Options.minSeconds / m_Options.samples, result.perfIterations);
+            result.perf = m_Counters.Stop();
+        }
+        printf("%-36s %8d %6d %12zu %14.3f %10.3f %12llu %14llu %10llu %14llu\n", name.c_str(), fibers, ringSize, vertices,
+            result.secondsPerCall * 1e6, result.secondsPerCall * 1e9 / vertices,
+            result.allocationsPerCall.allocations, result.allocationsPerCall.bytes,
+            result.glPerCall.drawCalls, result.glPerCall.uploadBytes);
+        if (result.perf.valid)
+        {
+            double calls = (double)result.perfIterations;
+            printf("%-36s %8s %6s %12s cycles/call %.0f, IPC %.2f, cache misses/vertex %.3f, branch misses/vertex %.3f\n",
+                "", "", "", "", result.perf.cycles / calls, GetIpc(result.perf),
+                result.perf.cacheMisses / calls / vertices, result.perf.branchMisses / calls / vertices);
+        }
+        fflush(stdout);
+        m_Results.push_back(result);
+    }
+
+    bool WriteCsv(const std::string& path) const
+    {
+        FILE* file = fopen(path.c_str(), "w");
+        if (!file)
+        {
+            printf("Could not open %s\n", path.c_str());
+            return false;
+        }
+        fprintf(file, "benchmark,fibers,ring_size,vertices,iterations,us_per_call,ns_per_vertex,allocs_per_call,bytes_per_call,"
+            "gl_calls_per_call,draws_per_call,program_binds_per_call,vao_binds_per_call,uniforms_per_call,upload_bytes_per_call,"
+            "cycles_per_call,instructions_per_call,ipc,cache_misses_per_vertex,branch_misses_per_vertex\n");
+        for (size_t i = 0; i < m_Results.size(); i++)
+        {
+            const BenchResult& r = m_Results[i];
+            fprintf(file, "%s,%d,%d,%zu,%lld,%.3f,%.4f,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu", r.name.c_str(), r.fibers, r.ringSize,
+                r.vertices, r.iterations, r.secondsPerCall * 1e6, r.secondsPerCall * 1e9 / r.vertices,
+                r.allocationsPerCall.allocations, r.allocationsPerCall.bytes, r.glPerCall.glCalls, r.glPerCall.drawCalls,
+                r.glPerCall.programBinds, r.glPerCall.vaoBinds, r.glPerCall.uniformSets, r.glPerCall.uploadBytes);
+            if (r.perf.valid)
+            {
+                double calls = (double)r.perfIterations;
+                fprintf(file, ",%.0f,%.0f,%.3f,%.5f,%.5f\n", r.perf.cycles / calls, r.perf.instructions / calls, GetIpc(r.perf),
+                    r.perf.cacheMisses / calls / r.vertices, r.perf.branchMisses / calls / r.vertices);
+            }
+            else
+            {
+                fprintf(file, ",,,,,\n"); //left empty rather than zero so plots skip them
+            }
+        }
+        return fclose(file) == 0;
+    }
+
+private:
+    static double GetIpc(const PerfSample& sample)
+    {
+        return sample.cycles ? (double)sample.instructions / sample.cycles : 0.0;
+    }
+
+    BenchOptions m_Options;
+    std::vector<BenchResult> m_Results;
+    PerfCounters m_Counters;
+};
+
+static std::vector<int> ParseList(const std::string& list)
+{
+    std::vector<int> values;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        int value = atoi(item.c_str());
+        if (value > 0)
+            values.push_back(value);
+    }
+    return values;
+}
+
+static bool ParseBenchOptions(int argc, char** argv, BenchOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--fibers" && hasValue)
+            options.fiberCounts = ParseList(argv[++i]);
+        else if (arg == "--rings" && hasValue)
+            options.ringSizes = ParseList(argv[++i]);
+        else if (arg == "--min-time" && hasValue)
+            options.minSeconds = atof(argv[++i]);
+        else if (arg == "--samples" && hasValue)
+            options.samples = std::max(1, atoi(argv[++i]));
+        else if (arg == "--filter" && hasValue)
+            options.filter = argv[++i];
+        else if (arg == "--csv" && hasValue)
+            options.csv = argv[++i];
+        else if (arg == "--perf")
+            options.perf = true;
+        else
+        {
+            printf("Usage: hopf_bench --sweep ... (see hopf_bench --sweep --help)\n");
+            printf("       hopf_bench [--fibers 100,1000,10000] [--rings 64,315,1024] [--min-time seconds]"
+                   " [--samples N] [--filter name] [--csv results.csv] [--perf]\n");
+            return false;
+        }
+    }
+    return !options.fiberCounts.empty() && !options.ringSizes.empty();
+}
+
+// Keeps results observable so the optimizer cannot drop the kernel
+static volatile double g_Sink;
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && std::string(argv[1]) == "--sweep")
+        return RunSweep(argc, argv);
+
+    BenchOptions options;
+    if (!ParseBenchOptions(argc, argv, options))
+        return -1;
+    BenchRunner runner(options);
+
+    printf("%-36s %8s %6s %12s %14s %10s %12s %14s %10s %14s\n", "benchmark", "fibers", "ring", "vertices", "us/call", "ns/vertex",
+        "allocs/call", "bytes/call", "draws/call", "upload B/call");
+    if (!AllocationTracker::IsAvailable())
+        printf("(allocation columns need a build with HOPF_TRACK_ALLOCATIONS)\n");
+
+    // Generators and GetColor: one vertex per base point
+    for (size_t f = 0; f < options.fiberCounts.size(); f++)
+    {
+        int n = options.fiberCounts[f];
+        if (runner.IsEnabled("GenerateGreatCircle"))
+            runner.Run("GenerateGreatCircle", n, 0, n, [&]() { g_Sink = GenerateGreatCircle(0.3f, 0.2f, 0.1f, n)[0][0]; });
+        if (runner.IsEnabled("GenerateUniform"))
+            runner.Run("GenerateUniform", n, 0, n, [&]() { g_Sink = GenerateUniform(n)[0][0]; });
+        if (runner.IsEnabled("GenerateRandom"))
+        {
+            srand(1);
+            runner.Run("GenerateRandom", n, 0, n, [&]() { g_Sink = GenerateRandom(n)[0][0]; });
+        }
+        if (runner.IsEnabled("GenerateElevation"))
+            runner.Run("GenerateElevation", n, 0, n, [&]() { g_Sink = GenerateElevation(n, PI / 4)[0][0]; });
+        if (runner.IsEnabled("GetColor"))
+        {
+            std::vector<std::vector<double>> points = GenerateUniform(n);
+            runner.Run("GetColor", n, 0, n, [&]() {
+                double sum = 0.0;
+                for (size_t i = 0; i < points.size(); i++)
+                    sum += GetColor(points[i])[0];
+                g_Sink = sum;
+            });
+        }
+    }
+
+    // Lift and projection kernels that take a ring size: the FiberSet builders
+    for (size_t f = 0; f < options.fiberCounts.size(); f++)
+    {
+        int n = options.fiberCounts[f];
+        std::vector<std::vector<double>> points = GenerateUniform(n);
+        for (size_t r = 0; r < options.ringSizes.size(); r++)
+        {
+            int ring = options.ringSizes[r];
+            double phiInc = GetPhiStep(ring);
+            size_t vertices = (size_t)n * GetFiberSampleCount(phiInc);
+            FiberSet fiberSet;
+            if (runner.IsEnabled("BuildFiberSet/double"))
+                runner.Run("BuildFiberSet/double", n, ring, vertices, [&]() {
+                    BuildFiberSet(points, fiberSet, phiInc, FiberPrecision::Double);
+                });
+            if (runner.IsEnabled("BuildFiberSet/float"))
+                runner.Run("BuildFiberSet/float", n, ring, vertices, [&]() {
+                    BuildFiberSet(points, fiberSet, phiInc, FiberPrecision::Float);
+                });
+        }
+    }
+
+    // Hopf and Points own GL buffers, so their kernels need a context; Hopf samples at FIBER_PHI_STEP only
+    bool wantsGL = runner.IsEnabled("Hopf::InverseHopfMap") || runner.IsEnabled("Hopf::StereographicProjection")
+        || runner.IsEnabled("Hopf::Draw") || runner.IsEnabled("Points::GenerateVertices");
+    HeadlessContext context;
+    if (wantsGL && !context.Create(4, 1))
+    {
+        printf("No OpenGL context; skipping Hopf and Points benchmarks\n");
+    }
+    else if (wantsGL)
+    {
+        int ring = (int)GetFiberSampleCount(FIBER_PHI_STEP);
+        for (size_t f = 0; f < options.fiberCounts.size(); f++)
+        {
+            int n = options.fiberCounts[f];
+            std::vector<std::vector<double>> points = GenerateUniform(n);
+            size_t vertices = (size_t)n * ring;
+            {
+                Hopf hopf(&points, false, 1.0f);
+                if (runner.IsEnabled("Hopf::InverseHopfMap"))
+                    runner.Run("Hopf::InverseHopfMap", n, ring, vertices, [&]() { hopf.InverseHopfMap(); });
+                if (runner.IsEnabled("Hopf::StereographicProjection"))
+                    runner.Run("Hopf::StereographicProjection", n, ring, vertices, [&]() { hopf.StereographicProjection(); });
+                if (runner.IsEnabled("Hopf::Draw"))
+                {
+                    Shader shader("res/shaders/Fiber.shader");
+                    shader.Bind();
+                    runner.Run("Hopf::Draw", n, ring, vertices, [&]() { hopf.Draw(shader); glFinish(); });
+                }
+            }
+            if (runner.IsEnabled("Points::GenerateVertices"))
+            {
+                Points drawer(points, 1.0f);
+                runner.Run("Points::GenerateVertices", n, 0, n, [&]() { drawer.GenerateVertices(); });
+            }
+        }
+    }
+
+    if (!options.csv.empty() && !runner.WriteCsv(options.csv))
+        return -1;
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,291 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FiberSet.hpp"
+#include "GlobalFunctions.hpp"
+#include "Headless.hpp"
+#include "ProcessStats.hpp"
+#include "Profiler.hpp"
+#include "AllocationTracker.hpp"
+#include "Verify.hpp"
+#include "ThreadPool.hpp"
+
+// Window-less driver: generates base points, lifts them to fibers with the same engine the viewer uses,
+// then times, exports, renders or verifies them and reports the run as one JSON object on the last line of stdout.
+
+struct CliOptions
+{
+    std::string action = "time";        //time, export, render or verify
+    std::string generator = "greatcircle";
+    int numFibers = 1000;
+    float rotation[3] = { 0.0f, 0.0f, 0.0f };   //greatcircle
+    double elevation = PI / 4;          //elevation
+    unsigned int seed = 1;              //random
+    int samples = 0;                    //samples per fiber, 0 = FIBER_PHI_STEP
+    FiberPrecision precision = FiberPrecision::Double;
+    int repeat = 1;                     //time: number of builds averaged
+    int threads = 0;                    //time: build on a pool of this many threads, 0 = serial
+    std::string stats;                  //also write the JSON here
+    std::string trace;                  //record profiler zones and write a Chrome trace here
+    HeadlessOptions headless;
+};
+
+static void PrintUsage()
+{
+    std::cout << "Usage: hopf_cli time|export|render|verify [options]\n"
+                 "  --generator greatcircle|uniform|random|elevation\n"
+                 "  --fibers N                 number of base points (verify: random points checked)\n"
+                 "  --rotation X Y Z           great circle rotation in radians\n"
+                 "  --elevation A              elevation circle latitude in radians\n"
+                 "  --seed S                   random generator and verify seed\n"
+                 "  --samples N                samples per fiber (default " << GetFiberSampleCount(FIBER_PHI_STEP) << ")\n"
+                 "  --precision float|double   arithmetic used to lift and project fibers\n"
+                 "  --repeat N                 time: builds to average over\n"
+                 "  --threads N                time: build on N threads (the content hash must not change)\n"
+                 "  --width W --height H       render: image size\n"
+                 "  --output path              export: .ply/.obj/.gltf, render: .png/.ppm\n"
+                 "  --export-geometry fibers|tubes|surface\n"
+                 "  --gpu-resident             render: free CPU copies of geometry once uploaded\n"
+                 "  --vertex-format float|half|snorm16\n"
+                 "                             render: fiber positions on the GPU (16, 12 or 8 bytes a vertex)\n"
+                 "  --stats file.json          also write the stats to a file\n"
+                 "  --trace file.json          write a Chrome trace of the run" << std::endl;
+}
+
+static bool ParseCliOptions(int argc, char** argv, CliOptions& options)
+{
+    if (argc < 2)
+    {
+        PrintUsage();
+        return false;
+    }
+    options.action = argv[1];
+    if (options.action != "time" && options.action != "export" && options.action != "render" && options.action != "verify")
+    {
+        PrintUsage();
+        return false;
+    }
+    options.headless.output = "";
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--generator" && hasValue)
+            options.generator = argv[++i];
+        else if (arg == "--fibers" && hasValue)
+            options.numFibers = atoi(argv[++i]);
+        else if (arg == "--rotation" && i + 3 < argc)
+        {
+            for (int axis = 0; axis < 3; axis++)
+                options.rotation[axis] = (float)atof(argv[++i]);
+        }
+        else if (arg == "--elevation" && hasValue)
+            options.elevation = atof(argv[++i]);
+        else if (arg == "--seed" && hasValue)
+            options.seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--samples" && hasValue)
+            options.samples = atoi(argv[++i]);
+        else if (arg == "--precision" && hasValue)
+        {
+            std::string precision = argv[++i];
+            if (precision != "float" && precision != "double")
+            {
+                std::cout << "Unknown precision: " << precision << std::endl;
+                return false;
+            }
+            options.precision = precision == "float" ? FiberPrecision::Float : FiberPrecision::Double;
+        }
+        else if (arg == "--repeat" && hasValue)
+            options.repeat = atoi(argv[++i]);
+        else if (arg == "--threads" && hasValue)
+            options.threads = atoi(argv[++i]);
+        else if (arg == "--width" && hasValue)
+            options.headless.width = atoi(argv[++i]);
+        else if (arg == "--height" && hasValue)
+            options.headless.height = atoi(argv[++i]);
+        else if (arg == "--fov" && hasValue)
+            options.headless.fov = (float)atof(argv[++i]);
+        else if (arg == "--output" && hasValue)
+            options.headless.output = argv[++i];
+        else if (arg == "--export-geometry" && hasValue)
+        {
+            std::string geometry = argv[++i];
+            if (geometry != "fibers" && geometry != "tubes" && geometry != "surface")
+            {
+                std::cout << "Unknown export geometry: " << geometry << std::endl;
+                return false;
+            }
+            options.headless.exportGeometry = geometry == "tubes" ? 1 : geometry == "surface" ? 2 : 0;
+        }
+        else if (arg == "--gpu-resident")
+            options.headless.gpuResident = true;
+        else if (arg == "--vertex-format" && hasValue)
+        {
+            std::string format = argv[++i];
+            if (!ParseVertexFormat(format, options.headless.vertexFormat))
+            {
+                std::cout << "Unknown vertex format: " << format << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--stats" && hasValue)
+            options.stats = argv[++i];
+        else if (arg == "--trace" && hasValue)
+            options.trace = argv[++i];
+        else
+        {
+            std::cout << "Unknown option: " << arg << std::endl;
+            PrintUsage();
+            return false;
+        }
+    }
+    if (options.numFibers <= 0 || options.repeat <= 0 || options.threads < 0 || options.samples < 0 || (options.samples > 0 && options.samples < 3))
+    {
+        std::cout << "Invalid options" << std::endl;
+        return false;
+    }
+    if ((options.action == "export" || options.action == "render") && options.headless.output.empty())
+    {
+        options.headless.output = options.action == "export" ? "hopf.ply" : "hopf.png";
+    }
+    return true;
+}
+
+static bool GenerateBasePoints(const CliOptions& options, std::vector<std::vector<double>>& points)
+{
+    if (options.generator == "greatcircle")
+        points = GenerateGreatCircle(options.rotation[0], options.rotation[1], options.rotation[2], options.numFibers);
+    else if (options.generator == "uniform")
+        points = GenerateUniform(options.numFibers);
+    else if (options.generator == "random")
+    {
+        srand(options.seed);
+        points = GenerateRandom(options.numFibers);
+    }
+    else if (options.generator == "elevation")
+        points = GenerateElevation(options.numFibers, options.elevation);
+    else
+    {
+        std::cout << "Unknown generator: " << options.generator << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::string EscapeJson(const std::string& s)
+{
+    std::string escaped;
+    for (size_t i = 0; i < s.size(); i++)
+    {
+        if (s[i] == '"' || s[i] == '\\')
+            escaped += '\\';
+        escaped += s[i];
+    }
+    return escaped;
+}
+
+int main(int argc, char** argv)
+{
+    CliOptions options;
+    if (!ParseCliOptions(argc, argv, options))
+        return -1;
+
+    // Any sample count is reachable: N steps of 2pi / (N - 0.5) stay below 2pi, N + 1 do not
+    options.headless.phiInc = options.samples > 0 ? 2 * PI / (options.samples - 0.5) : FIBER_PHI_STEP;
+    options.headless.precision = options.precision;
+    unsigned int samples = GetFiberSampleCount(options.headless.phiInc);
+    if (!options.trace.empty())
+    {
+        Profiler::SetEnabled(true);
+        Profiler::SetThreadName("Main thread");
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<std::vector<double>> points;
+    if (!GenerateBasePoints(options, points))
+        return -1;
+    double generateSeconds = SecondsSince(start);
+
+    size_t numVertices = points.size() * samples;
+    double seconds = 0.0;   //time spent in the action, per repetition
+    int result = 0;
+    std::string hash = "null"; //content hash of the fiber set, when the action builds one
+    if (options.action == "time")
+    {
+        FiberSet fiberSet;
+        std::unique_ptr<ThreadPool> pool(options.threads > 0 ? new ThreadPool(options.threads) : nullptr);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < options.repeat; i++)
+        {
+            if (pool)
+                BuildFiberSet(points, fiberSet, options.headless.phiInc, options.precision, *pool);
+            else
+                BuildFiberSet(points, fiberSet, options.headless.phiInc, options.precision);
+        }
+        seconds = SecondsSince(start) / options.repeat;
+        char hex[32];
+        snprintf(hex, sizeof(hex), "\"%016llx\"", (unsigned long long)fiberSet.GetContentHash());
+        hash = hex;
+    }
+    else if (options.action == "verify")
+    {
+        // Invariants over random base points; the generator above only sizes the report
+        VerifyOptions verifyOptions;
+        verifyOptions.numPoints = options.numFibers;
+        verifyOptions.seed = options.seed;
+        verifyOptions.phiInc = options.headless.phiInc;
+        start = std::chrono::steady_clock::now();
+        result = RunVerify(verifyOptions) == 0 ? 0 : 1;
+        seconds = SecondsSince(start);
+    }
+    else
+    {
+        if (options.action == "export")
+            options.headless.exportPath = options.headless.output;
+        start = std::chrono::steady_clock::now();
+        result = RunHeadless(options.headless, points);
+        seconds = SecondsSince(start);
+    }
+
+    if (!options.trace.empty())
+        Profiler::WriteTrace(options.trace);
+
+    AllocationStats allocations = AllocationTracker::GetTotal();
+    char json[2048];
+    snprintf(json, sizeof(json),
+        "{\"action\": \"%s\", \"generator\": \"%s\", \"precision\": \"%s\", \"fibers\": %zu, \"samples_per_fiber\": %u, "
+        "\"vertices\": %zu, \"repeat\": %d, \"generate_seconds\": %.6f, \"seconds\": %.6f, "
+        "\"fibers_per_second\": %.1f, \"vertices_per_second\": %.1f, \"peak_rss_bytes\": %zu, "
+        "\"allocation_tracking\": %s, \"allocations\": %llu, \"allocated_bytes\": %llu, \"peak_live_bytes\": %llu, "
+        "\"hash\": %s, \"output\": \"%s\", \"ok\": %s}",
+        options.action.c_str(), EscapeJson(options.generator).c_str(),
+        options.precision == FiberPrecision::Float ? "float" : "double",
+        points.size(), samples, numVertices, options.repeat, generateSeconds, seconds,
+        seconds > 0.0 ? points.size() / seconds : 0.0, seconds > 0.0 ? numVertices / seconds : 0.0,
+        GetPeakResidentBytes(), AllocationTracker::IsAvailable() ? "true" : "false", allocations.allocations, allocations.bytes,
+        AllocationTracker::GetPeakLiveBytes(), hash.c_str(), EscapeJson(options.headless.output).c_str(), result == 0 ? "true" : "false");
+    std::cout << json << std::endl;
+
+    if (!options.stats.empty())
+    {
+        FILE* file = fopen(options.stats.c_str(), "w");
+        if (!file)
+        {
+            std::cout << "Could not open " << options.stats << std::endl;
+            return -1;
+        }
+        fprintf(file, "%s\n", json);
+        fclose(file);
+    }
+    return result;
+}
\ No newline at end of file
@@ -9,6 +9,10 @@
 #include <algorithm>
 #include <unordered_map>
 #include <string>
+#include <memory>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
 
 #include "Renderer.hpp"
 #include "VertexBuffer.hpp"
@@ -21,10 +25,21 @@
 #include "Controls.hpp"
 #include "FrameBuffer.hpp"
 #include "GlobalFunctions.hpp"
+#include "Headless.hpp"
+#include "FrameExporter.hpp"
+#include "FiberSetFile.hpp"
+#include "MeshExporter.hpp"
+#include "Scene.hpp"
+#include "Profiler.hpp"
+#include "FrameStats.hpp"
+#include "AllocationTracker.hpp"
+#include "GLStats.hpp"
+#include "BufferArena.hpp"
+#include "Residency.hpp"
+#include "CameraPath.hpp"
 #include "render_geom/CoordinateAxis/CoordinateAxis.hpp"
 #include "render_geom/Plane/Plane.hpp"
 #include "render_geom/Sphere/Sphere.hpp"
-#include "render_geom/Circle/Circle.hpp"
 #include "render_geom/Hopf/Hopf.hpp"
 #include "render_geom/Points/Points.hpp"
 
@@ -43,8 +58,34 @@ int fullscreenHeight = 1080;
 int windowedWidth = 1920;
 int windowedHeight = 1080;
 
-int main()
+int main(int argc, char** argv)
 {
+    if (argc > 1 && std::string(argv[1]) == "--headless")
+    {
+        HeadlessOptions headlessOptions;
+        if (!ParseHeadlessOptions(argc, argv, headlessOptions))
+            return -1;
+        return RunHeadless(headlessOptions);
+    }
+    std::string fiberSetPath;
+    std::string replayPath;     //camera path to replay at startup; the viewer exits when it ends
+    std::string replayLogPath;  //per-frame CSV of the replay
+    VertexFormat vertexFormat = VertexFormat::Float32; //fiber and preview point positions on the GPU
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (std::string(argv[i]) == "--load" && hasValue)
+            fiberSetPath = argv[i + 1];
+        else if (std::string(argv[i]) == "--replay" && hasValue)
+            replayPath = argv[i + 1];
+        else if (std::string(argv[i]) == "--replay-log" && hasValue)
+            replayLogPath = argv[i + 1];
+        else if (std::string(argv[i]) == "--gpu-resident")
+            Residency::SetGpuResident(true);
+        else if (std::string(argv[i]) == "--vertex-format" && hasValue)
+            ParseVertexFormat(argv[i + 1], vertexFormat);
+    }
+
     float size = 50.0;
     bool render = false;
     bool menu = true;
@@ -55,6 +96,7 @@ int main()
     bool hideUi = false;
     bool fullscreen = false;
     bool vsync = true;
+    bool recording = false;
     float escCooldown = 0.5f;
     float pointSize = 5.0f;
     float elevation = 0.0f;
@@ -101,14 +143,7 @@ int main()
 
     //INITIALIZATION OPTIONS
 
-    GLCall(glEnable(GL_CULL_FACE));
-    GLCall(glCullFace(GL_FRONT));
-    GLCall(glFrontFace(GL_CCW));
-    GLCall(glEnable(GL_BLEND));
-    GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
-    GLCall(glViewport(0, 0, windowedWidth, windowedHeight));
-    GLCall(glEnable(GL_DEPTH_TEST));
-    GLCall(glDepthFunc(GL_LESS));
+    ConfigureRenderState(windowedWidth, windowedHeight);
     //GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
 
     // IMGUI INITIALIZATION
@@ -122,6 +157,7 @@ int main()
 
         Shader shader("res/shaders/Basic.shader"); //create a shader
         Shader shader2("res/shaders/Points.shader"); //create a shader
+        Shader fiberShader("res/shaders/Fiber.shader"); //per-vertex RGBA8 fiber colors
 
         // CREATE OBJECTS
 
@@ -146,10 +182,19 @@ int main()
         points.push_back(GenerateGreatCircle(rotationXs[0], rotationYs[0], rotationZs[0], numPoints[0]));
         
         std::vector<Hopf> hopfs;
-        hopfs.push_back(Hopf(&(points[0]), drawAsPoints, pointSize));
+        hopfs.push_back(Hopf(&(points[0]), drawAsPoints, pointSize, vertexFormat));
+        if (!fiberSetPath.empty())
+        {
+            // Show a precomputed set until the base points are edited
+            MappedFiberSet mapped;
+            if (mapped.Open(fiberSetPath))
+            {
+                hopfs[0] = Hopf(mapped.GetRawView(), drawAsPoints, pointSize, vertexFormat);
+            }
+        }
 
         std::vector<Points> pointsDrawers;
-        pointsDrawers.push_back(Points(points[0], 10.0f));
+        pointsDrawers.push_back(Points(points[0], 10.0f, vertexFormat));
 
         Axis axis(10000.0f);
 
@@ -159,7 +204,6 @@ int main()
         fbo.AttachTexture();
         
         Plane plane(10000.0f, 10000.0f);
-        glm::vec3 translationA(0, -1000.0f, 0);
         
         // MOVEMENT SETTINGS
 
@@ -168,13 +212,250 @@ int main()
         float sensitivity = 0.1f;
 
 
+        std::unique_ptr<FrameExporter> recorder;
+
+        // Zones go into ring buffers, so F2 always dumps the last few seconds
+        Profiler::SetEnabled(true);
+        Profiler::SetThreadName("Main thread");
+
+        GpuTimer gpuTimer(GetScenePassNames());
+        bool logGpuTimings = false;
+
+        FrameStats frameStats;
+        bool logFrameTimes = false;
+        double recordStartTime = 0.0;
+
+        // Finishes the frame recording started by the "Record Frames" checkbox
+        auto stopRecording = [&](double time)
+        {
+            double elapsed = time - recordStartTime;
+            recorder->Finish(elapsed > 0.0 ? recorder->GetFramesCaptured() / elapsed : 0.0);
+            std::cout << "Recorded " << recorder->GetFramesCaptured() << " frames to " << recorder->GetDirectory() << std::endl;
+            recorder.reset();
+            recording = false;
+        };
+
+        int exportFormat = 0;
+        int exportGeometry = 0;
+        const char* exportFormats[] = {".ply", ".obj", ".gltf"};
+        const char* exportGeometries[] = {"Fibers", "Tubes", "Surface"};
+
         int currentMode = 0; 
         char* modes[] = {"Great Circle", "Uniform", "Random", "Elevation"};
 
+        unsigned int randomSeed = 1; //Random mode reseeds with this before generating, so replays get the same points
+
+        // Regenerates every fiber set from the current controls
+        auto rebuildFibers = [&]()
+        {
+            int numSets = currentMode == 0 ? numGreatCircles : (currentMode == 3 ? numElevationCircles : 1);
+            rotationXs.resize(std::max((int)rotationXs.size(), numGreatCircles), 0.0f);
+            rotationYs.resize(rotationXs.size(), 0.0f);
+            rotationZs.resize(rotationXs.size(), 0.0f);
+            elevations.resize(std::max((int)elevations.size(), numElevationCircles), 0.0f);
+            points.clear();
+            srand(randomSeed);
+            for(int i = 0; i < numSets; i++)
+            {
+                switch(currentMode)
+                {
+                    case 0: points.push_back(GenerateGreatCircle(rotationXs[i], rotationYs[i], rotationZs[i], numPoints[0])); break;
+                    case 1: points.push_back(GenerateUniform(numPoints[1])); break;
+                    case 2: points.push_back(GenerateRandom(numPoints[2])); break;
+                    default: points.push_back(GenerateElevation(numPoints[3], elevations[i])); break;
+                }
+            }
+            hopfs.clear();
+            pointsDrawers.clear();
+            for(int i = 0; i < numSets; i++)
+            {
+                hopfs.push_back(Hopf(&(points[i]), drawAsPoints, pointSize, vertexFormat));
+                pointsDrawers.push_back(Points(points[i], 10.0f, vertexFormat));
+            }
+        };
+
+        // CAMERA PATHS
+
+        CameraPath cameraPath;
+        std::string cameraPathFile = replayPath;
+        bool recordingPath = false;
+        int replayFrame = -1;               //frame of cameraPath being replayed, -1 when not replaying
+        bool stopReplay = false;            //"Stop Replay" pressed; the replay ends after this frame
+        long long replayFirstFrame = 0;     //frameStats index of replay frame 0
+        bool replayRestoreVsync = vsync;
+        std::unique_ptr<FrameStats> replayStats;
+
+        // Everything a replay has to reproduce besides the camera
+        auto collectParams = [&]()
+        {
+            CameraPathParams params;
+            params["mode"] = (float)currentMode;
+            params["seed"] = (float)randomSeed;
+            for(int i = 0; i < 4; i++)
+            {
+                params["fibers." + std::to_string(i)] = (float)numPoints[i];
+            }
+            params["great_circles"] = (float)numGreatCircles;
+            params["elevation_circles"] = (float)numElevationCircles;
+            for(int i = 0; i < numGreatCircles && i < (int)rotationXs.size(); i++)
+            {
+                params["rotation_x." + std::to_string(i)] = rotationXs[i];
+                params["rotation_y." + std::to_string(i)] = rotationYs[i];
+                params["rotation_z." + std::to_string(i)] = rotationZs[i];
+            }
+            for(int i = 0; i < numElevationCircles && i < (int)elevations.size(); i++)
+            {
+                params["elevation." + std::to_string(i)] = elevations[i];
+            }
+            params["ground"] = drawGround;
+            params["axis"] = drawCoordinateAxis;
+            params["circle"] = drawCircle;
+            params["draw_as_points"] = drawAsPoints;
+            params["point_size"] = pointSize;
+            params["hide_ui"] = hideUi;
+            return params;
+        };
+
+        auto applyParams = [&](const CameraPathParams& changes)
+        {
+            bool rebuild = false;
+            for(CameraPathParams::const_iterator it = changes.begin(); it != changes.end(); ++it)
+            {
+                const std::string& name = it->first;
+                float value = it->second;
+                size_t dot = name.find('.');
+                std::string key = name.substr(0, dot);
+                int index = dot == std::string::npos ? 0 : std::max(0, std::min(atoi(name.c_str() + dot + 1), 99));
+                rebuild = true;
+                if(key == "mode") currentMode = std::max(0, std::min((int)value, 3));
+                else if(key == "seed") randomSeed = (unsigned int)value;
+                else if(key == "fibers" && index < 4) numPoints[index] = (int)value;
+                else if(key == "great_circles") numGreatCircles = std::max(1, (int)value);
+                else if(key == "elevation_circles") numElevationCircles = std::max(1, (int)value);
+                else if(key == "rotation_x" || key == "rotation_y" || key == "rotation_z")
+                {
+                    std::vector<float>& rotations = key == "rotation_x" ? rotationXs : (key == "rotation_y" ? rotationYs : rotationZs);
+                    rotations.resize(std::max((int)rotations.size(), index + 1), 0.0f);
+                    rotations[index] = value;
+                }
+                else if(key == "elevation")
+                {
+                    elevations.resize(std::max((int)elevations.size(), index + 1), 0.0f);
+                    elevations[index] = value;
+                }
+                else
+                {
+                    rebuild = false;
+                    if(key == "ground") drawGround = value != 0.0f;
+                    else if(key == "axis") drawCoordinateAxis = value != 0.0f;
+                    else if(key == "circle") drawCircle = value != 0.0f;
+                    else if(key == "draw_as_points") { drawAsPoints = value != 0.0f; rebuild = true; }
+                    else if(key == "point_size") { pointSize = value; rebuild = true; }
+                    else if(key == "hide_ui") hideUi = value != 0.0f;
+                }
+            }
+            if(rebuild)
+            {
+                rebuildFibers();
+            }
+        };
+
+        auto startReplay = [&](const std::string& path)
+        {
+            if(!cameraPath.Load(path))
+            {
+                return;
+            }
+            recordingPath = false;
+            menu = false;
+            render = true;
+            glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL); //keeps the mouse from steering
+            replayRestoreVsync = vsync;
+            vsync = false; //frame times should measure rendering, not the display
+            SetVsync(vsync);
+            replayStats.reset(new FrameStats(cameraPath.GetNumFrames()));
+            if(!replayLogPath.empty())
+            {
+                replayStats->StartLog(replayLogPath);
+            }
+            replayFrame = 0;
+        };
+
+        // Hands the GPU times GpuTimer has collected to the frames they belong to
+        auto collectGpuTimes = [&]()
+        {
+            long long gpuFrame;
+            float gpuMs;
+            while(gpuTimer.PopFrameTime(gpuFrame, gpuMs))
+            {
+                frameStats.SetGpuTime(gpuFrame, gpuMs);
+                if(replayStats)
+                {
+                    replayStats->SetGpuTime(gpuFrame - replayFirstFrame, gpuMs);
+                }
+            }
+        };
+
+        // Called once the last replay frame is in the stats, so its CPU and GPU times both count
+        auto finishReplay = [&]()
+        {
+            gpuTimer.Drain();
+            collectGpuTimes();
+            FrameTimePercentiles cpu = replayStats->GetCpuPercentiles();
+            FrameTimePercentiles gpu = replayStats->GetGpuPercentiles();
+            std::cout << "Replayed " << replayFrame << " of " << cameraPath.GetNumFrames() << " frames of " << cameraPathFile << std::endl;
+            printf("      p50     p95     p99     max (ms)\n");
+            printf("CPU %7.2f %7.2f %7.2f %7.2f (%d frames)\n", cpu.p50, cpu.p95, cpu.p99, cpu.max, cpu.count);
+            printf("GPU %7.2f %7.2f %7.2f %7.2f (%d frames)\n", gpu.p50, gpu.p95, gpu.p99, gpu.max, gpu.count);
+            replayStats.reset();
+            replayFrame = -1;
+            stopReplay = false;
+            vsync = replayRestoreVsync;
+            SetVsync(vsync);
+            if(!replayPath.empty())
+            {
+                glfwSetWindowShouldClose(window, true);
+            }
+        };
+
+        if(!replayPath.empty())
+        {
+            startReplay(replayPath);
+            if(replayFrame < 0)
+            {
+                glfwSetWindowShouldClose(window, true);
+            }
+        }
+
         // RENDERING LOOP
         while (!glfwWindowShouldClose(window))
         {
-            float time = glfwGetTime(); // Get the current time in seconds
+            PROFILE_SCOPE("Frame");
+            // Replays run on simulated time so every run sees the same frames
+            float time = replayFrame >= 0 ? (float)(replayFrame * CameraPath::TimeStep) : glfwGetTime(); // Get the current time in seconds
+            // CPU time is added once the frame is done, under the same index GpuTimer gives this frame
+            double frameStart = glfwGetTime();
+            double now = frameStart; //wall clock, for key cooldowns and recordings, which a replay does not reproduce
+            gpuTimer.BeginFrame();
+            AllocationTracker::BeginFrame();
+            GLStats::BeginFrame();
+
+            if(replayFrame >= 0)
+            {
+                if(replayFrame == 0)
+                {
+                    replayFirstFrame = frameStats.GetNextFrame();
+                }
+                CameraPathParams changes;
+                cameraPath.GetChanges(replayFrame, changes);
+                applyParams(changes);
+                const CameraPathFrame& pathFrame = cameraPath.GetFrame(replayFrame);
+                camera.SetPosition(pathFrame.position);
+                camera.SetOrientation(pathFrame.yaw, pathFrame.pitch);
+                fov = pathFrame.fov;
+                camera.SetFOV(fov);
+            }
+            CameraPathFrame frameCamera = { camera.getPosition(), camera.getYaw(), camera.getPitch(), camera.getFOV() };
 
             glm::mat4 viewMatrix = camera.GetViewMatrix();
             glm::mat4 projectionMatrix = camera.GetProjectionMatrix();
@@ -204,8 +485,22 @@ int main()
                 ImGui::Text("ESC - Show Menu");
                 ImGui::Text("Left Alt - Toggle Mouse");
                 ImGui::Text("F1 - Hide UI");
+                ImGui::Text("F2 - Dump Profiler Trace");
                 ImGui::Text("F11 - Toggle Fullscreen");
 
+                if(ImGui::Checkbox("Log Frame Times", &logFrameTimes))
+                {
+                    if(logFrameTimes)
+                    {
+                        std::string path = "frame_times_" + std::to_string((long long)std::time(nullptr)) + ".csv";
+                        logFrameTimes = frameStats.StartLog(path);
+                    }
+                    else
+                    {
+                        frameStats.StopLog();
+                    }
+                }
+
                 if (ImGui::Button("Exit Application"))
                 {
 					glfwSetWindowShouldClose(window, true);
@@ -216,6 +511,7 @@ int main()
             {
                 if(!hideUi)
                 {
+                    ALLOC_SCOPE("UI and updates");
                     ImGui::SetNextWindowSize(ImVec2(400, 900));
                     ImGui::SetNextWindowPos(ImVec2(20, 120)); // Position: x=50, y=50
                     ImGui::Begin("Object Controls");
@@ -231,11 +527,7 @@ int main()
                             if(ImGui::Selectable(modes[n], is_selected))
                             {
                                 currentMode = n;
-                                Initialize(points, currentMode, numPoints[currentMode]); 
-                                pointsDrawers.clear();
-                                pointsDrawers.push_back(Points(points[0], 10.0f));
-                                hopfs.clear();
-                                hopfs.push_back(Hopf(&(points[0]), drawAsPoints, pointSize));
+                                rebuildFibers();
                             }
                             if(is_selected)
                             {
@@ -289,8 +581,8 @@ int main()
                                     rotationYs.push_back(0.0f);
                                     rotationZs.push_back(0.0f);
                                     points.push_back(GenerateGreatCircle(rotationXs[i], rotationYs[i], rotationZs[i], numPoints[0]));
-                                    hopfs.push_back(Hopf(&(points[i]), drawAsPoints, pointSize));
-                                    pointsDrawers.push_back(Points(points[i], 10.0f));
+                                    hopfs.push_back(Hopf(&(points[i]), drawAsPoints, pointSize, vertexFormat));
+                                    pointsDrawers.push_back(Points(points[i], 10.0f, vertexFormat));
                                 }
                             }
                             else if(numGreatCircles < hopfs.size())
@@ -322,6 +614,7 @@ int main()
                         if(ImGui::SliderInt("Number of Points", &numPoints[2], 1, 200))
                         {
                             points.clear();
+                            srand(++randomSeed); //fresh points, and the new seed goes into a recorded path
                             points.push_back(GenerateRandom(numPoints[2]));
                             pointsDrawers[0].UpdatePoints(&(points[0]));
                             hopfs[0].UpdateCircles(&(points[0]));
@@ -354,8 +647,8 @@ int main()
                                 {
                                     elevations.push_back(0.0f);
                                     points.push_back(GenerateElevation(numPoints[3], elevations[i]));
-                                    hopfs.push_back(Hopf(&(points[i]), drawAsPoints, pointSize));
-                                    pointsDrawers.push_back(Points(points[i], 10.0f));
+                                    hopfs.push_back(Hopf(&(points[i]), drawAsPoints, pointSize, vertexFormat));
+                                    pointsDrawers.push_back(Points(points[i], 10.0f, vertexFormat));
                                 }
                             }
                             else if(numElevationCircles < hopfs.size())
@@ -372,6 +665,76 @@ int main()
                     }
                     
                     
+                    if(ImGui::Checkbox("Record Frames", &recording))
+                    {
+                        if(recording)
+                        {
+                            int width, height;
+                            glfwGetFramebufferSize(window, &width, &height);
+                            std::string directory = "capture_" + std::to_string((long long)std::time(nullptr));
+                            recorder.reset(new FrameExporter(directory, width, height));
+                            recordStartTime = now;
+                        }
+                        else if(recorder)
+                        {
+                            stopRecording(now);
+                        }
+                    }
+                    if(recording && recorder)
+                    {
+                        ImGui::Text("Recording: %d frames", recorder->GetFramesCaptured());
+                    }
+
+                    if(ImGui::Checkbox("Record Camera Path", &recordingPath))
+                    {
+                        if(recordingPath)
+                        {
+                            cameraPath.Clear();
+                        }
+                        else
+                        {
+                            cameraPathFile = "camera_path_" + std::to_string((long long)std::time(nullptr)) + ".txt";
+                            if(cameraPath.Save(cameraPathFile))
+                            {
+                                std::cout << "Saved " << cameraPath.GetNumFrames() << " frames to " << cameraPathFile << std::endl;
+                            }
+                        }
+                    }
+                    if(recordingPath)
+                    {
+                        ImGui::Text("Recording path: %d frames", cameraPath.GetNumFrames());
+                    }
+                    else if(replayFrame >= 0)
+                    {
+                        ImGui::Text("Replaying: frame %d / %d", replayFrame, cameraPath.GetNumFrames());
+                        ImGui::SameLine();
+                        stopReplay = ImGui::Button("Stop Replay") || stopReplay;
+                    }
+                    else if(!cameraPathFile.empty() && ImGui::Button("Replay Camera Path"))
+                    {
+                        startReplay(cameraPathFile);
+                    }
+
+                    ImGui::Combo("Export Format", &exportFormat, exportFormats, 3);
+                    ImGui::Combo("Export Geometry", &exportGeometry, exportGeometries, 3);
+                    if(ImGui::Button("Export Mesh"))
+                    {
+                        ExportOptions exportOptions;
+                        std::vector<std::vector<double>> allPoints;
+                        for(size_t i = 0; i < points.size(); i++)
+                        {
+                            allPoints.insert(allPoints.end(), points[i].begin(), points[i].end());
+                            exportOptions.setSizes.push_back((unsigned int)points[i].size()); //each set its own surface
+                        }
+                        exportOptions.geometry = (ExportGeometry)exportGeometry;
+                        exportOptions.closeSurface = currentMode == 0 || currentMode == 3; //great and elevation circles are closed curves
+                        std::string path = "hopf_" + std::to_string((long long)std::time(nullptr)) + exportFormats[exportFormat];
+                        if(ExportFibers(allPoints, path, exportOptions))
+                        {
+                            std::cout << "Exported " << allPoints.size() << " fibers to " << path << std::endl;
+                        }
+                    }
+
                     if(ImGui::Checkbox("Draw as Points", &drawAsPoints))
                     {
                         for(int i = 0; i < numGreatCircles; i++)
@@ -394,16 +757,118 @@ int main()
                     // STATUS WINDOW
 
                     ImGui::SetNextWindowPos(ImVec2(20, 20));
-                    ImGui::SetNextWindowSize(ImVec2(400, 80));
+                    ImGui::SetNextWindowSize(ImVec2(400, 0));
                     ImGui::Begin("Status:");
                     ImGui::Text("Camera Position: %.3f, %.3f, %.3f", camera.getPosition().x, camera.getPosition().y, camera.getPosition().z);
                     ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
                     ImGui::Text("Time: %.3fs", time);
+                    {
+                        std::vector<uint64_t> hopfHashes;
+                        for(size_t i = 0; i < hopfs.size(); i++)
+                        {
+                            hopfHashes.push_back(hopfs[i].GetContentHash());
+                        }
+                        uint64_t hash = hopfHashes.size() == 1 ? hopfHashes[0] : CombineFiberHashes(hopfHashes.data(), hopfHashes.size());
+                        ImGui::Text("Content hash: %016llx", (unsigned long long)hash);
+                    }
+                    if(ImGui::CollapsingHeader("Frame Times"))
+                    {
+                        FrameTimePercentiles cpu = frameStats.GetCpuPercentiles();
+                        FrameTimePercentiles gpu = frameStats.GetGpuPercentiles();
+                        ImGui::Text("      p50     p95     p99     max (ms)");
+                        ImGui::Text("CPU %7.2f %7.2f %7.2f %7.2f", cpu.p50, cpu.p95, cpu.p99, cpu.max);
+                        ImGui::Text("GPU %7.2f %7.2f %7.2f %7.2f", gpu.p50, gpu.p95, gpu.p99, gpu.max);
+                        float scale = std::max(cpu.max, gpu.max);
+                        ImGui::PlotHistogram("CPU", frameStats.GetCpuHistory(), frameStats.GetHistorySize(), frameStats.GetHistoryOffset(),
+                                             nullptr, 0.0f, scale, ImVec2(0, 60));
+                        ImGui::PlotHistogram("GPU", frameStats.GetGpuHistory(), frameStats.GetHistorySize(), frameStats.GetHistoryOffset(),
+                                             nullptr, 0.0f, scale, ImVec2(0, 60));
+                    }
+                    if(ImGui::CollapsingHeader("Allocations"))
+                    {
+                        if(AllocationTracker::IsAvailable())
+                        {
+                            AllocationStats last = AllocationTracker::GetLastFrame();
+                            AllocationStats worst = AllocationTracker::GetMaxFrame();
+                            ImGui::Text("Last frame: %llu allocations, %.1f KB", last.allocations, last.bytes / 1024.0);
+                            ImGui::Text("Worst frame: %llu allocations, %.1f KB", worst.allocations, worst.bytes / 1024.0);
+                            ImGui::Text("Live: %.2f MB (peak %.2f MB)", AllocationTracker::GetLiveBytes() / 1048576.0,
+                                        AllocationTracker::GetPeakLiveBytes() / 1048576.0);
+                            AllocationScopeStats scopes[32];
+                            int numScopes = AllocationTracker::GetScopes(scopes, 32);
+                            for(int i = 0; i < numScopes; i++)
+                            {
+                                ImGui::Text("%-26s %6llu calls %9.1f allocs/call (max %llu)", scopes[i].name, scopes[i].calls,
+                                            (double)scopes[i].total.allocations / scopes[i].calls, scopes[i].maxPerCall.allocations);
+                            }
+                            if(ImGui::Button("Reset High-Water Marks"))
+                            {
+                                AllocationTracker::ResetHighWater();
+                                AllocationTracker::ResetScopes();
+                            }
+                        }
+                        else
+                        {
+                            ImGui::Text("Build with HOPF_TRACK_ALLOCATIONS to count allocations");
+                        }
+                    }
+                    if(ImGui::CollapsingHeader("GL Counters"))
+                    {
+                        const GLCounters& gl = GLStats::GetLastFrame();
+                        ImGui::Text("Draw calls: %llu (%llu elements)", gl.drawCalls, gl.elementsDrawn);
+                        ImGui::Text("Program binds: %llu  VAO binds: %llu  Buffer binds: %llu", gl.programBinds, gl.vaoBinds, gl.bufferBinds);
+                        ImGui::Text("Uniform sets: %llu  GL calls: %llu", gl.uniformSets, gl.glCalls);
+                        ImGui::Text("Uploads: %llu (%.1f KB)", gl.uploads, gl.uploadBytes / 1024.0);
+                    }
+                    if(ImGui::CollapsingHeader("Buffer Arena"))
+                    {
+                        BufferArenaStats arena = BufferArena::Get().GetStats();
+                        ImGui::Text("Blocks: %u (%.1f KB)", arena.blocks, arena.capacity / 1024.0);
+                        ImGui::Text("Used: %.1f KB in %u ranges", arena.used / 1024.0, arena.allocations);
+                        ImGui::Text("Free ranges: %u  Largest free: %.1f KB", arena.freeRanges, arena.largestFree / 1024.0);
+                        ImGui::Text("Allocated: %llu  Freed: %llu", arena.totalAllocations, arena.totalFrees);
+                        bool gpuResident = Residency::IsGpuResident();
+                        if(ImGui::Checkbox("GPU-Resident Geometry", &gpuResident))
+                        {
+                            // Takes effect on upload, so rebuild to apply it to what is on screen
+                            Residency::SetGpuResident(gpuResident);
+                            rebuildFibers();
+                        }
+                        const char* vertexFormats[] = { "Float (16 B/vertex)", "Half (12 B/vertex)", "Snorm16 (8 B/vertex)" };
+                        int currentFormat = (int)vertexFormat;
+                        if(ImGui::Combo("Vertex Format", &currentFormat, vertexFormats, 3))
+                        {
+                            vertexFormat = (VertexFormat)currentFormat;
+                            rebuildFibers();
+                        }
+                    }
+                    if(ImGui::CollapsingHeader("GPU Timings"))
+                    {
+                        for(int pass = 0; pass < gpuTimer.GetNumPasses(); pass++)
+                        {
+                            ImGui::Text("%-8s %7.3f ms", gpuTimer.GetPassName(pass).c_str(), gpuTimer.GetAverageMs(pass));
+                        }
+                        ImGui::Text("%-8s %7.3f ms", "frame", gpuTimer.GetAverageFrameMs());
+                        ImGui::Text("Dropped samples: %lld", gpuTimer.GetDroppedFrames());
+                        if(ImGui::Checkbox("Log GPU Timings", &logGpuTimings))
+                        {
+                            if(logGpuTimings)
+                            {
+                                std::string path = "gpu_timings_" + std::to_string((long long)std::time(nullptr)) + ".csv";
+                                logGpuTimings = gpuTimer.StartLog(path);
+                            }
+                            else
+                            {
+                                gpuTimer.StopLog();
+                            }
+                        }
+                    }
                     ImGui::End();
 
                     // S2 Sphere Preview Window
 
                     fbo.Bind();
+                    gpuTimer.Begin(SCENE_PASS_PREVIEW);
                     {
                         GLCall(glClearColor(0.0f, 0.0, 0.0, 0.5f));
                         renderer.Clear();
@@ -422,6 +887,7 @@ int main()
                             pointsDrawers[i].Draw();
                         }
                     }
+                    gpuTimer.End(SCENE_PASS_PREVIEW);
                     fbo.Unbind();
                     ImGui::SetNextWindowSize(ImVec2(300, 300));
                     ImGui::SetNextWindowPos(ImVec2(1600, 20)); // Position: x=50, y=50
@@ -430,36 +896,24 @@ int main()
                     ImGui::End();
                 }
                 
-                GLCall(glClearColor(0.529f, 0.828f, 0.952f, 1.0f));
-                renderer.Clear();
-                if (drawCoordinateAxis)
-                {   //Coordinate axis
-                    shader.Bind();
-                    glm::mat4 model = glm::mat4(1.0f); //create a model matrix
-                    glm::mat4 mvp = projectionMatrix * viewMatrix * model;
-                    shader.SetUniformMat4f("u_MVP", mvp); //set the uniform
-                    shader.SetUniform4f("u_Color", 1.0f, 1.0f, 1.0f, 1.0f); //set the uniform
-                    glLineWidth(3.0f);
-                    axis.Draw();
-                }
-                if (drawGround)
-                {   //Green plane
-                    shader.Bind();
-                    glm::mat4 model = glm::translate(glm::mat4(1.0f), translationA); //create a model matrix
-                    glm::mat4 mvp = projectionMatrix * viewMatrix * model;
-                    shader.SetUniform4f("u_Color", 0.482f, 0.62f, 0.451f, 1.0f); //set the uniform
-                    shader.SetUniformMat4f("u_MVP", mvp); //set the uniform
-                    plane.Draw();
-                }
-                if(drawCircle)
+                SceneOptions sceneOptions;
+                sceneOptions.drawGround = drawGround;
+                sceneOptions.drawCoordinateAxis = drawCoordinateAxis;
+                sceneOptions.drawCircle = drawCircle;
+                DrawScene(renderer, shader, fiberShader, axis, plane, hopfs, viewMatrix, projectionMatrix, sceneOptions, &gpuTimer);
+                if(recorder)
                 {
-                    shader.Bind();
-                    glm::mat4 model = glm::mat4(1.0f); //create a model matrix
-                    glm::mat4 mvp = projectionMatrix * viewMatrix * model;
-                    shader.SetUniformMat4f("u_MVP", mvp); //set the uniform
-                    for(int i = 0; i < hopfs.size(); i++)
+                    // The readback ring is sized for the framebuffer at the start; a resize ends the recording
+                    int width, height;
+                    glfwGetFramebufferSize(window, &width, &height);
+                    if(width != recorder->GetWidth() || height != recorder->GetHeight())
+                    {
+                        std::cout << "Framebuffer resized to " << width << "x" << height << ", stopping the recording" << std::endl;
+                        stopRecording(now);
+                    }
+                    else
                     {
-                        hopfs[i].Draw(&shader);
+                        recorder->CaptureFrame(); //before ImGui draws, so the UI is not recorded
                     }
                 }
 
@@ -468,9 +922,12 @@ int main()
                 camera.setSpeed(speed);
                 camera.setSensitivity(sensitivity);
 
-                camera.ProcessControls();
+                if(replayFrame < 0)
+                {
+                    camera.ProcessControls();
+                }
 
-                if(glfwGetKey(window, GLFW_KEY_LEFT_ALT) == GLFW_PRESS && time - lastKeyPressTime > escCooldown)
+                if(glfwGetKey(window, GLFW_KEY_LEFT_ALT) == GLFW_PRESS && now - lastKeyPressTime > escCooldown)
                 {
                     if(glfwGetInputMode(window, GLFW_CURSOR) == GLFW_CURSOR_NORMAL)
                     {
@@ -480,16 +937,16 @@ int main()
                     {
                         glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
                     }
-                    lastKeyPressTime = time;
+                    lastKeyPressTime = now;
                 }
-                if(glfwGetKey(window, GLFW_KEY_F1) == GLFW_PRESS && time - lastKeyPressTime > escCooldown)
+                if(glfwGetKey(window, GLFW_KEY_F1) == GLFW_PRESS && now - lastKeyPressTime > escCooldown)
                 {
                     hideUi = !hideUi;
-                    lastKeyPressTime = time;
+                    lastKeyPressTime = now;
                 }
             }
 
-            if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS && time - lastKeyPressTime > escCooldown)
+            if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS && now - lastKeyPressTime > escCooldown)
             {
                 ChangeStates(menu, render);
                 if(menu)
@@ -500,10 +957,16 @@ int main()
                 {
                     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
                 }
-                lastKeyPressTime = time;
+                lastKeyPressTime = now;
+            }
+
+            if (glfwGetKey(window, GLFW_KEY_F2) == GLFW_PRESS && now - lastKeyPressTime > escCooldown)
+            {
+                Profiler::WriteTrace("trace_" + std::to_string((long long)std::time(nullptr)) + ".json");
+                lastKeyPressTime = now;
             }
 
-            if (glfwGetKey(window, GLFW_KEY_F11) == GLFW_PRESS && time - lastKeyPressTime > escCooldown)
+            if (glfwGetKey(window, GLFW_KEY_F11) == GLFW_PRESS && now - lastKeyPressTime > escCooldown)
             {
                 fullscreen = !fullscreen; // Toggle the fullscreen flag
                 if (fullscreen) {
@@ -525,18 +988,43 @@ int main()
                     glViewport(0, 0, windowedWidth, windowedHeight);
                     SetVsync(vsync);
                 }
-                lastKeyPressTime = time;
+                lastKeyPressTime = now;
             }
 
+            if(recordingPath && render)
+            {
+                cameraPath.AddFrame(frameCamera, collectParams());
+            }
+            bool replayDone = replayFrame >= 0 && (++replayFrame >= cameraPath.GetNumFrames() || stopReplay);
+
             ImGui::Render();
+            gpuTimer.Begin(SCENE_PASS_IMGUI);
             ImGui_ImplGlfwGL3_RenderDrawData(ImGui::GetDrawData());
+            gpuTimer.End(SCENE_PASS_IMGUI);
+            gpuTimer.EndFrame();
+            collectGpuTimes();
 
             /* Swap front and back buffers */
-            glfwSwapBuffers(window);
+            {
+                PROFILE_SCOPE("SwapBuffers");
+                glfwSwapBuffers(window);
+            }
 
             /* Poll for and process events */
             glfwPollEvents();
+
+            float frameMs = (float)((glfwGetTime() - frameStart) * 1000.0);
+            frameStats.AddFrame(frameMs);
+            if(replayStats)
+            {
+                replayStats->AddFrame(frameMs);
+            }
+            if(replayDone)
+            {
+                finishReplay();
+            }
         }
+        gpuTimer.Delete();
     }
     ImGui_ImplGlfwGL3_Shutdown();
     ImGui::DestroyContext();
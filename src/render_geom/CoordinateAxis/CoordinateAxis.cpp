@@ -1,4 +1,5 @@
 #include "CoordinateAxis.hpp"
+#include "../../GLStats.hpp"
 
 Axis::Axis(float length)
 	: m_length(length), m_vertices({
@@ -13,7 +14,7 @@ Axis::Axis(float length)
     // Z-axis
     0.0f, 0.0f, 0.0f, // Start point
     0.0f, 0.0f, m_length  // End point
-        }), m_vb(&m_vertices[0], m_vertices.size() * sizeof(float)), m_va(), m_vbl()
+        }), m_vb(&m_vertices[0], m_vertices.size() * sizeof(float), BufferArena::Get()), m_va(), m_vbl()
 {
     m_vbl.Push<float>(3);
     m_va.AddBuffer(m_vb, m_vbl, false);
@@ -26,4 +27,5 @@ void Axis::Draw() {
     m_va.Bind();
 	m_vb.Bind();
 	GLCall(glDrawArrays(GL_LINES, 0, 6));
+	GLStats::CountDraw(6);
 }
@@ -1,36 +1,135 @@
 #include "Hopf.hpp"
+#include "../../Profiler.hpp"
+#include "../../AllocationTracker.hpp"
+#include "../../GLStats.hpp"
+#include "../../Residency.hpp"
 
-Hopf::Hopf(const std::vector<std::vector<double>>* points, bool drawAsPoints = false, float pointSize = 1.0f)
-    : m_NumFibers(points->size()), m_S2Points(points)
+#include <cstring>
+#include <iostream>
+
+static unsigned char PackColorChannel(float c)
+{
+    c = c < 0.0f ? 0.0f : (c > 1.0f ? 1.0f : c);
+    return (unsigned char)(c * 255.0f + 0.5f);
+}
+
+Hopf::Hopf(const std::vector<std::vector<double>>* points, bool drawAsPoints = false, float pointSize = 1.0f, VertexFormat format)
+    : m_NumFibers(points->size()), m_Format(format)
 {
+    SetBasePoints(*points);
     m_DrawAsPoints = drawAsPoints;
     m_PointSize = pointSize;
-    m_S2Circles.resize(m_NumFibers);
     m_S3Circles = std::vector<std::vector<std::vector<double>>>(m_NumFibers);
     GenerateVertices();
     GenerateColors();
 }
 
+// Float positions of one fiber: in place for float sets, expanded into scratch for quantized ones
+static const float* GetFiberPositions(const FiberSetView& fiberSet, unsigned int fiber, std::vector<float>& scratch)
+{
+    size_t first = fiberSet.firsts[fiber];
+    if (fiberSet.vertices)
+        return fiberSet.vertices + first * 3;
+    const int16_t* quantized = fiberSet.quantizedVertices + first * 3;
+    const float* bounds = fiberSet.fiberBounds + (size_t)fiber * 6;
+    scratch.resize((size_t)fiberSet.counts[fiber] * 3);
+    for (size_t j = 0; j < scratch.size(); j++)
+        scratch[j] = DequantizeSnorm16(quantized[j], bounds[j % 3], bounds[3 + j % 3]);
+    return scratch.data();
+}
+
+Hopf::Hopf(const FiberSetView& fiberSet, bool drawAsPoints = false, float pointSize = 1.0f, VertexFormat format)
+    : m_NumFibers(fiberSet.numFibers), m_Format(format)
+{
+    m_DrawAsPoints = drawAsPoints;
+    m_PointSize = pointSize;
+    m_VertexHashes.resize(m_NumFibers);
+    m_Firsts.resize(m_NumFibers);
+    m_Counts.resize(m_NumFibers);
+    m_Colors.resize(m_NumFibers);
+    m_NumVertices = fiberSet.numVertices;
+
+    bool sections = true; //fiber i at i * count, so the shader can find it from gl_VertexID
+    for (unsigned int i = 0; i < m_NumFibers && sections; i++)
+    {
+        sections = fiberSet.counts[i] == fiberSet.counts[0] && fiberSet.firsts[i] == (size_t)i * fiberSet.counts[0];
+    }
+    std::vector<float> scratch;
+    if (sections)
+    {
+        for (unsigned int i = 0; i < m_NumFibers; i++)
+        {
+            const float* color = fiberSet.colors + i * 4;
+            m_VertexHashes[i] = HashFiberVertices(GetFiberPositions(fiberSet, i, scratch), fiberSet.counts[i]);
+            m_Colors[i] = glm::vec4(color[0], color[1], color[2], color[3]);
+            m_Firsts[i] = (int)fiberSet.firsts[i];
+            m_Counts[i] = (int)fiberSet.counts[i];
+        }
+        UploadSections(fiberSet);
+        return;
+    }
+
+    // Fibers of mixed length are repacked and interleaved with their colors
+    m_Vertices.resize(fiberSet.numVertices);
+    size_t first = 0;
+    for (unsigned int i = 0; i < m_NumFibers; i++)
+    {
+        const float* vertices = GetFiberPositions(fiberSet, i, scratch);
+        const float* color = fiberSet.colors + i * 4;
+        m_VertexHashes[i] = HashFiberVertices(vertices, fiberSet.counts[i]);
+        m_Colors[i] = glm::vec4(color[0], color[1], color[2], color[3]);
+        m_Firsts[i] = (int)first;
+        m_Counts[i] = (int)fiberSet.counts[i];
+        for (unsigned int j = 0; j < fiberSet.counts[i]; j++)
+        {
+            FiberVertex& out = m_Vertices[first + j];
+            out.position[0] = vertices[j * 3 + 0];
+            out.position[1] = vertices[j * 3 + 1];
+            out.position[2] = vertices[j * 3 + 2];
+        }
+        WriteColors(i);
+        first += fiberSet.counts[i];
+    }
+    Upload();
+}
+
 void Hopf::UpdateCircles(const std::vector<std::vector<double>>* points)
 {
-    m_S2Circles.resize(points->size());
+    PROFILE_FUNCTION();
+    ALLOC_SCOPE("Hopf::UpdateCircles");
+    m_Colors.clear(); //regenerated below, after the projection
     m_S3Circles = std::vector<std::vector<std::vector<double>>>(points->size());
-    m_S2Points = points;
+    SetBasePoints(*points);
     m_NumFibers = points->size();
     GenerateVertices();
     GenerateColors();
 }
 
+void Hopf::SetBasePoints(const std::vector<std::vector<double>>& points)
+{
+    m_BasePoints.resize(points.size() * 3);
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        m_BasePoints[i * 3 + 0] = points[i][0];
+        m_BasePoints[i * 3 + 1] = points[i][1];
+        m_BasePoints[i * 3 + 2] = points[i][2];
+    }
+}
+
 void Hopf::InverseHopfMap()
 {
+    PROFILE_FUNCTION();
+    if (m_BasePoints.empty())
+        return; //built from precomputed fibers; there is nothing to lift
+    m_S3Circles.resize(m_NumFibers);
     for (int i = 0; i < m_NumFibers; i++)
     {
         std::vector<std::vector<double>> pointsR4;
-        double x = (*m_S2Points)[i][0];
-        double y = (*m_S2Points)[i][1];
-        double z = (*m_S2Points)[i][2];
+        double x = m_BasePoints[i * 3 + 0];
+        double y = m_BasePoints[i * 3 + 1];
+        double z = m_BasePoints[i * 3 + 2];
         
-        double phiInc = 0.02;
+        double phiInc = FIBER_PHI_STEP;
         for(double phi = 0; phi <= 2 * PI; phi += phiInc)
         {
             double f = 1 / sqrt(2 * (1 + z));
@@ -47,20 +146,50 @@ void Hopf::InverseHopfMap()
 
 void Hopf::StereographicProjection()
 {
+    PROFILE_FUNCTION();
+    if (m_S3Circles.size() != m_NumFibers)
+    {
+        InverseHopfMap(); //released after the last upload
+        if (m_S3Circles.size() != m_NumFibers)
+            return;
+    }
+    m_VertexHashes.resize(m_NumFibers);
+    m_Firsts.resize(m_NumFibers);
+    m_Counts.resize(m_NumFibers);
+    size_t numVertices = 0;
     for (int i = 0; i < m_NumFibers; i++)
     {
-        std::vector<float> pointsR3;
+        m_Firsts[i] = (int)numVertices;
+        m_Counts[i] = (int)m_S3Circles[i].size();
+        numVertices += m_S3Circles[i].size();
+    }
+    m_Vertices.resize(numVertices);
+    m_NumVertices = numVertices;
+
+    bool hasColors = m_Colors.size() == m_NumFibers;
+    std::vector<float> pointsR3; //one fiber's positions, packed for the hash
+    for (int i = 0; i < m_NumFibers; i++)
+    {
+        pointsR3.clear();
         for (int j = 0; j < m_S3Circles[i].size(); j++)
         {
-            float x = m_S3Circles[i][j][0];
-            float y = m_S3Circles[i][j][1];
-            float z = m_S3Circles[i][j][2];
-            float w = m_S3Circles[i][j][3];
-            pointsR3.push_back(x / (1 - w) * 400.0);
-            pointsR3.push_back(y / (1 - w) * 400.0);
-            pointsR3.push_back(z / (1 - w) * 400.0);
+            // In double and rounded once, as LiftFibers<double> does, so the content hash matches the CLI's
+            const std::vector<double>& q = m_S3Circles[i][j];
+            double s = FIBER_PROJECTION_SCALE / (1 - q[3]);
+            pointsR3.push_back((float)(q[0] * s));
+            pointsR3.push_back((float)(q[1] * s));
+            pointsR3.push_back((float)(q[2] * s));
         }
-        m_S2Circles[i] = Circle(pointsR3, (int)m_S3Circles[i].size() - 1, m_DrawAsPoints, m_PointSize);
+        m_VertexHashes[i] = HashFiberVertices(pointsR3.data(), (unsigned int)m_Counts[i]);
+        for (int j = 0; j < m_Counts[i]; j++)
+        {
+            FiberVertex& out = m_Vertices[m_Firsts[i] + j];
+            out.position[0] = pointsR3[j * 3 + 0];
+            out.position[1] = pointsR3[j * 3 + 1];
+            out.position[2] = pointsR3[j * 3 + 2];
+        }
+        if (hasColors)
+            WriteColors(i);
     }
 }
 
@@ -72,42 +201,314 @@ void Hopf::GenerateVertices()
 
 void Hopf::GenerateColors()
 {
-    m_Colors.clear();
+    PROFILE_FUNCTION();
+    if (m_BasePoints.empty())
+        return; //colors came with the precomputed fibers
+    if (m_Vertices.size() != m_NumVertices)
+    {
+        m_Colors.clear(); //so the projection leaves the upload to us
+        StereographicProjection();
+    }
+    m_Colors.resize(m_NumFibers);
     for (int i = 0; i < m_NumFibers; i++)
     {
-        m_Colors.push_back(GetColor((*m_S2Points)[i]));
+        std::vector<double> color = GetColor({m_BasePoints[i * 3 + 0], m_BasePoints[i * 3 + 1], m_BasePoints[i * 3 + 2]});
+        m_Colors[i] = glm::vec4((float)color[0], (float)color[1], (float)color[2], (float)color[3]);
+        WriteColors(i);
     }
+    Upload();
 }
 
-void Hopf::Draw(Shader * shader)
+void Hopf::WriteColors(unsigned int fiber)
 {
-    for(size_t i = 0; i < m_S2Circles.size(); i++)
+    unsigned char rgba[4];
+    for (int c = 0; c < 4; c++)
+        rgba[c] = PackColorChannel(m_Colors[fiber][c]);
+    FiberVertex* out = m_Vertices.empty() ? nullptr : &m_Vertices[m_Firsts[fiber]];
+    for (int j = 0; j < m_Counts[fiber]; j++)
     {
-        float r = m_Colors[i][0];
-        float g = m_Colors[i][1];
-        float b = m_Colors[i][2];
-        float a = 1.0f;
-        shader->SetUniform4f("u_Color", r, g, b, a); //set the uniform
-        m_S2Circles[i].Draw();
+        out[j].color[0] = rgba[0];
+        out[j].color[1] = rgba[1];
+        out[j].color[2] = rgba[2];
+        out[j].color[3] = rgba[3];
     }
 }
 
-void Hopf::SetDrawAsPoints(bool drawAsPoints)
+static void PushFiberLayout(VertexBufferLayout& layout, VertexFormat format)
 {
-    m_DrawAsPoints = drawAsPoints;
-    for (int i = 0; i < m_NumFibers; i++)
+    switch (format)
     {
-        m_S2Circles[i].SetDrawAsPoints(drawAsPoints);
+    case VertexFormat::Float32:
+        layout.Push<float>(3);
+        layout.Push<unsigned char>(4); //normalized, read as vec4 in [0, 1]
+        break;
+    case VertexFormat::Half:
+        layout.Push<HalfFloat>(4);
+        layout.Push<unsigned char>(4);
+        break;
+    case VertexFormat::Snorm16:
+        layout.Push<short>(4); //the color comes from the fiber data
+        break;
     }
 }
 
-void Hopf::ChangePointSize(float pointSize)
+VertexFormat Hopf::SelectFormat() const
 {
-    m_PointSize = pointSize;
-    for (int i = 0; i < m_NumFibers; i++)
+    if (m_Format != VertexFormat::Snorm16)
+        return m_Format;
+    for (size_t i = 1; i < m_Counts.size(); i++)
     {
-        m_S2Circles[i].ChangePointSize(pointSize);
+        if (m_Counts[i] != m_Counts[0] || m_Firsts[i] != m_Firsts[i - 1] + m_Counts[0])
+            return VertexFormat::Half;
     }
+    return VertexFormat::Snorm16;
+}
+
+// Returns the bytes to upload: m_Vertices itself for Float32, otherwise the packed copy
+const void* Hopf::PackVertices(VertexFormat format, std::vector<unsigned char>& packed, std::vector<glm::vec4>& fiberData) const
+{
+    if (format == VertexFormat::Float32 || m_Vertices.empty())
+        return m_Vertices.empty() ? nullptr : m_Vertices.data();
+
+    if (format == VertexFormat::Half)
+    {
+        packed.resize(m_Vertices.size() * sizeof(FiberVertexHalf));
+        FiberVertexHalf* out = (FiberVertexHalf*)packed.data();
+        uint16_t one = FloatToHalf(1.0f);
+        for (size_t i = 0; i < m_Vertices.size(); i++)
+        {
+            for (int axis = 0; axis < 3; axis++)
+                out[i].position[axis].bits = FloatToHalf(m_Vertices[i].position[axis]);
+            out[i].position[3].bits = one;
+            memcpy(out[i].color, m_Vertices[i].color, sizeof(out[i].color));
+        }
+        return packed.data();
+    }
+
+    // Each fiber quantized against its own box (QuantizeSnorm16); the box and color go to the buffer texture
+    packed.resize(m_Vertices.size() * sizeof(FiberVertexSnorm16));
+    FiberVertexSnorm16* out = (FiberVertexSnorm16*)packed.data();
+    fiberData.resize((size_t)m_NumFibers * 3);
+    for (unsigned int i = 0; i < m_NumFibers; i++)
+    {
+        const FiberVertex* in = &m_Vertices[m_Firsts[i]];
+        float minimum[3] = { 0.0f, 0.0f, 0.0f };
+        float maximum[3] = { 0.0f, 0.0f, 0.0f };
+        for (int j = 0; j < m_Counts[i]; j++)
+        {
+            for (int axis = 0; axis < 3; axis++)
+            {
+                float value = in[j].position[axis];
+                minimum[axis] = (j == 0 || value < minimum[axis]) ? value : minimum[axis];
+                maximum[axis] = (j == 0 || value > maximum[axis]) ? value : maximum[axis];
+            }
+        }
+        for (int j = 0; j < m_Counts[i]; j++)
+        {
+            FiberVertexSnorm16& v = out[m_Firsts[i] + j];
+            for (int axis = 0; axis < 3; axis++)
+                v.position[axis] = QuantizeSnorm16(in[j].position[axis], minimum[axis], maximum[axis]);
+            v.position[3] = 32767;
+        }
+        fiberData[i * 3 + 0] = glm::vec4((minimum[0] + maximum[0]) * 0.5f, (minimum[1] + maximum[1]) * 0.5f, (minimum[2] + maximum[2]) * 0.5f, 0.0f);
+        fiberData[i * 3 + 1] = glm::vec4((maximum[0] - minimum[0]) * 0.5f, (maximum[1] - minimum[1]) * 0.5f, (maximum[2] - minimum[2]) * 0.5f, 0.0f);
+        fiberData[i * 3 + 2] = m_Colors[i];
+    }
+    return packed.data();
+}
+
+void Hopf::Upload()
+{
+    PROFILE_FUNCTION();
+    VertexFormat format = SelectFormat();
+    std::vector<unsigned char> packed;
+    std::vector<glm::vec4> fiberData;
+    const void* data = PackVertices(format, packed, fiberData);
+    size_t bytes = format == VertexFormat::Float32 ? m_Vertices.size() * sizeof(FiberVertex) : packed.size();
+    if (!CheckBufferSize(bytes, fiberData.size() * sizeof(glm::vec4)))
+        return;
+    unsigned int size = (unsigned int)bytes;
+    if (!m_HasBuffer)
+    {
+        m_VBO = VertexBuffer(data, size);
+        PushFiberLayout(m_VBL, format);
+        m_VAO.AddBuffer(m_VBO, m_VBL, false);
+        m_HasBuffer = true;
+    }
+    else
+    {
+        if (format != m_UploadedFormat || m_FromSections)
+        {   // The new layout may enable fewer attributes, so it starts from a fresh vertex array
+            m_VAO = VertexArray();
+            m_VBL = VertexBufferLayout();
+            PushFiberLayout(m_VBL, format);
+        }
+        // Edited sets stream through a ring, so a new upload never waits for draws of the previous one
+        if (!m_Stream.IsValid())
+        {
+            m_Stream = StreamBuffer(size);
+            m_VBO.Delete();
+        }
+        size_t offset = m_Stream.Write(data, size);
+        m_VAO.AddBuffer(m_Stream, offset, m_VBL, false);
+    }
+    m_UploadedFormat = format;
+    m_FromSections = false;
+
+    if (format == VertexFormat::Snorm16)
+    {
+        unsigned int dataSize = (unsigned int)(fiberData.size() * sizeof(glm::vec4));
+        const void* fiberBytes = fiberData.empty() ? nullptr : fiberData.data();
+        if (m_FiberData.IsValid())
+            m_FiberData.UpdateData(fiberBytes, dataSize);
+        else
+            m_FiberData = BufferTexture(fiberBytes, dataSize, GL_RGBA32F);
+    }
+    else
+    {
+        m_FiberData.Delete();
+    }
+    if (Residency::IsGpuResident())
+        ReleaseCpuCopies();
+}
+
+// Sizes are computed in size_t and checked here, so a set too large for the buffers is dropped
+// instead of uploading a truncated buffer that the next draw would read past
+bool Hopf::CheckBufferSize(size_t vertexBytes, size_t fiberDataBytes)
+{
+    if (vertexBytes <= MaxBufferBytes && fiberDataBytes <= MaxBufferBytes)
+        return true;
+    std::cout << "Hopf: " << vertexBytes << " bytes of vertices exceed the " << MaxBufferBytes << " byte buffer limit, the set is not drawn" << std::endl;
+    m_VAO = VertexArray();
+    m_VBL = VertexBufferLayout();
+    m_VBO.Delete();
+    m_Stream = StreamBuffer();
+    m_FiberData.Delete();
+    m_HasBuffer = false;
+    m_FromSections = false;
+    return false;
+}
+
+void Hopf::ReleaseCpuCopies()
+{
+    // The S3 circles are four doubles per sample, twice the size of the uploaded vertices
+    ReleaseStorage(m_S3Circles);
+    ReleaseStorage(m_Vertices);
+}
+
+const std::vector<std::vector<std::vector<double>>>& Hopf::GetS3Circles()
+{
+    if (m_S3Circles.size() != m_NumFibers)
+        InverseHopfMap();
+    return m_S3Circles;
+}
+
+void Hopf::Draw(Shader& shader)
+{
+    PROFILE_FUNCTION();
+    ALLOC_SCOPE("Hopf::Draw");
+    if (m_Counts.empty() || !m_HasBuffer)
+        return;
+    bool fiberData = m_FiberData.IsValid();
+    shader.SetUniform1i("u_Quantized", fiberData ? 1 : 0);
+    if (fiberData)
+    {
+        m_FiberData.Bind(0);
+        shader.SetUniform1i("u_FiberData", 0);
+        shader.SetUniform1i("u_SamplesPerFiber", m_Counts[0]);
+    }
+    m_VAO.Bind();
+    if (m_DrawAsPoints)
+    {
+        GLCall(glPointSize(m_PointSize));
+    }
+    // Each fiber is its own primitive within the one call, so line loops close per fiber
+    GLCall(glMultiDrawArrays(m_DrawAsPoints ? GL_POINTS : GL_LINE_LOOP, &m_Firsts[0], &m_Counts[0], (GLsizei)m_Counts.size()));
+    GLStats::CountDraw(m_NumVertices);
+}
+
+void Hopf::GetFiberSet(FiberSet& fiberSet)
+{
+    if (m_Vertices.size() != m_NumVertices)
+        StereographicProjection(); //released after the last upload
+    fiberSet.Clear();
+    fiberSet.basePoints.assign(m_BasePoints.begin(), m_BasePoints.end());
+    fiberSet.firsts.assign(m_Firsts.begin(), m_Firsts.end());
+    fiberSet.counts.assign(m_Counts.begin(), m_Counts.end());
+    fiberSet.vertices.resize(m_Vertices.size() * 3);
+    for (size_t i = 0; i < m_Vertices.size(); i++)
+    {
+        fiberSet.vertices[i * 3 + 0] = m_Vertices[i].position[0];
+        fiberSet.vertices[i * 3 + 1] = m_Vertices[i].position[1];
+        fiberSet.vertices[i * 3 + 2] = m_Vertices[i].position[2];
+    }
+    fiberSet.colors.resize(m_Colors.size() * 4);
+    fiberSet.fiberHashes.resize(m_Colors.size());
+    for (size_t i = 0; i < m_Colors.size(); i++)
+    {
+        for (int c = 0; c < 4; c++)
+            fiberSet.colors[i * 4 + c] = m_Colors[i][c];
+        fiberSet.fiberHashes[i] = FinishFiberHash(m_VertexHashes[i], &m_Colors[i][0]);
+    }
+}
+
+uint64_t Hopf::GetContentHash() const
+{
+    std::vector<uint64_t> hashes(m_VertexHashes.size());
+    for (size_t i = 0; i < hashes.size() && i < m_Colors.size(); i++)
+    {
+        hashes[i] = FinishFiberHash(m_VertexHashes[i], &m_Colors[i][0]);
+    }
+    return CombineFiberHashes(hashes.empty() ? nullptr : &hashes[0], hashes.size());
+}
+
+// Uploads the position section of a stored set as it is, float or snorm16, with no interleaving.
+// Bounds and colors go to the fiber data; float sets get unit bounds, so the shader path is the same.
+void Hopf::UploadSections(const FiberSetView& fiberSet)
+{
+    PROFILE_FUNCTION();
+    bool quantized = fiberSet.vertices == nullptr;
+    const void* data = quantized ? (const void*)fiberSet.quantizedVertices : (const void*)fiberSet.vertices;
+    size_t bytes = m_NumVertices * 3 * (quantized ? sizeof(int16_t) : sizeof(float));
+    if (!CheckBufferSize(bytes, (size_t)m_NumFibers * 3 * sizeof(glm::vec4)))
+        return;
+    m_VBO = VertexBuffer(m_NumVertices > 0 ? data : nullptr, (unsigned int)bytes); //straight from the mapping
+    if (quantized)
+        m_VBL.Push<short>(3);
+    else
+        m_VBL.Push<float>(3);
+    m_VAO.AddBuffer(m_VBO, m_VBL, false);
+    m_HasBuffer = true;
+    m_FromSections = true;
+    m_UploadedFormat = quantized ? VertexFormat::Snorm16 : VertexFormat::Float32;
+
+    std::vector<glm::vec4> fiberData((size_t)m_NumFibers * 3);
+    for (unsigned int i = 0; i < m_NumFibers; i++)
+    {
+        if (quantized)
+        {
+            const float* bounds = fiberSet.fiberBounds + (size_t)i * 6;
+            fiberData[i * 3 + 0] = glm::vec4((bounds[0] + bounds[3]) * 0.5f, (bounds[1] + bounds[4]) * 0.5f, (bounds[2] + bounds[5]) * 0.5f, 0.0f);
+            fiberData[i * 3 + 1] = glm::vec4((bounds[3] - bounds[0]) * 0.5f, (bounds[4] - bounds[1]) * 0.5f, (bounds[5] - bounds[2]) * 0.5f, 0.0f);
+        }
+        else
+        {
+            fiberData[i * 3 + 0] = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f);
+            fiberData[i * 3 + 1] = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+        }
+        fiberData[i * 3 + 2] = m_Colors[i];
+    }
+    m_FiberData = BufferTexture(fiberData.empty() ? nullptr : fiberData.data(), (unsigned int)(fiberData.size() * sizeof(glm::vec4)), GL_RGBA32F);
+}
+
+void Hopf::SetDrawAsPoints(bool drawAsPoints)
+{
+    m_DrawAsPoints = drawAsPoints;
+}
+
+void Hopf::ChangePointSize(float pointSize)
+{
+    m_PointSize = pointSize;
 }
 
 Hopf::~Hopf()
@@ -6,38 +6,103 @@
 #include "../../VertexBuffer.hpp"
 #include "../../VertexArray.hpp"
 #include "../../VertexBufferLayout.hpp"
+#include "../../StreamBuffer.hpp"
+#include "../../BufferTexture.hpp"
+#include "../../VertexFormat.hpp"
 #include "../../IndexBuffer.hpp"
 #include "../../Shader.hpp"
 #include "../../GlobalFunctions.hpp"
-
-#include "../Circle/Circle.hpp"
+#include "../../FiberSet.hpp"
 
 #include <cmath>
 #include <vector>
 
+// One vertex of the packed fiber buffer: position and RGBA8 color, 16 bytes
+struct FiberVertex
+{
+    float position[3];
+    unsigned char color[4];
+};
+
+// VertexFormat::Half: 12 bytes
+struct FiberVertexHalf
+{
+    HalfFloat position[4]; //w = 1
+    unsigned char color[4];
+};
+
+// VertexFormat::Snorm16: 8 bytes. Position within the fiber's bounds; bounds and color are per fiber,
+// read by Fiber.shader from a buffer texture
+struct FiberVertexSnorm16
+{
+    int16_t position[4]; //w unused
+};
+
 class Hopf
 {
 public:
-    Hopf(const std::vector<std::vector<double>>* points, bool drawAsPoints, float pointSize);
-    Hopf(){}; // Default constructor
+    // Largest vertex or fiber-data buffer Hopf uploads; GL wrappers size buffers in 32 bits. Bigger sets are not drawn.
+    static const size_t MaxBufferBytes = 0xFFFFFF00u;
+
+    Hopf(const std::vector<std::vector<double>>* points, bool drawAsPoints, float pointSize, VertexFormat format = VertexFormat::Float32);
+    // Precomputed fibers, e.g. MappedFiberSet::GetRawView(). Sets of equal-length fibers are uploaded
+    // straight from their float or snorm16 section, in that format whatever format asks for.
+    Hopf(const FiberSetView& fiberSet, bool drawAsPoints, float pointSize, VertexFormat format = VertexFormat::Float32);
+    Hopf() : m_NumFibers(0), m_DrawAsPoints(false), m_PointSize(1.0f) {}; // Default constructor
     ~Hopf();
+    Hopf(Hopf&&) noexcept = default; //owns the fiber buffer, so moves only
+    Hopf& operator=(Hopf&&) noexcept = default;
+    Hopf(const Hopf&) = delete;
+    Hopf& operator=(const Hopf&) = delete;
 
     void UpdateCircles(const std::vector<std::vector<double>>* points);
     void InverseHopfMap();
-    void StereographicProjection();
+    void StereographicProjection(); //fills the CPU vertices only; GenerateColors uploads
     void GenerateVertices();
     void GenerateColors();
     void SetDrawAsPoints(bool drawAsPoints);
-    void Draw(Shader* shader);
+    // One glMultiDrawArrays for the whole set; expects Fiber.shader bound and sets its dequantization uniforms
+    void Draw(Shader& shader);
     void ChangePointSize(float pointSize);
+    // Snorm16 needs fibers of equal length (the shader finds the fiber from gl_VertexID); other sets fall back to Half
+    inline VertexFormat GetVertexFormat() const { return m_UploadedFormat; }
+    // Fibers on S3 from the last InverseHopfMap, xyzw per sample; recomputed if GPU residency released them
+    const std::vector<std::vector<std::vector<double>>>& GetS3Circles();
+    // Content hash of the uploaded vertices and colors, defined as for FiberSet::GetContentHash
+    uint64_t GetContentHash() const;
+    // The projected fibers as a FiberSet, for sets built from base points; verify checks them like any other kernel
+    void GetFiberSet(FiberSet& fiberSet);
 
 private:
+    void Upload();
+    void UploadSections(const FiberSetView& fiberSet);
+    VertexFormat SelectFormat() const;
+    const void* PackVertices(VertexFormat format, std::vector<unsigned char>& packed, std::vector<glm::vec4>& fiberData) const;
+    void WriteColors(unsigned int fiber);
+    void ReleaseCpuCopies();
+    bool CheckBufferSize(size_t vertexBytes, size_t fiberDataBytes);
+    void SetBasePoints(const std::vector<std::vector<double>>& points);
+
     unsigned int m_NumFibers;
     bool m_DrawAsPoints;
     float m_PointSize;
     std::vector<std::vector<std::vector<double>>> m_S3Circles;
-    std::vector<Circle> m_S2Circles;
-    const std::vector<std::vector<double>>* m_S2Points;
-    std::vector<std::vector<double>> m_Colors;
-    unsigned int m_numCols = 50;
+    std::vector<double> m_BasePoints; //xyz per fiber on S2, copied so the caller's vectors may move; empty for precomputed sets
+    std::vector<glm::vec4> m_Colors; //per fiber, kept in float for the content hash
+    std::vector<uint64_t> m_VertexHashes; //HashFiberVertices per fiber, taken as the vertices are projected
+
+    // Every fiber of the set in one buffer; fiber i is [m_Firsts[i], m_Firsts[i] + m_Counts[i])
+    std::vector<FiberVertex> m_Vertices;   //empty after upload in GPU-resident mode
+    size_t m_NumVertices = 0;
+    std::vector<int> m_Firsts;
+    std::vector<int> m_Counts;
+    VertexArray m_VAO;
+    VertexBuffer m_VBO;         //first upload; sets that never change stay here
+    StreamBuffer m_Stream;      //every later upload, once the set is being edited
+    VertexBufferLayout m_VBL;
+    bool m_HasBuffer = false;
+    VertexFormat m_Format = VertexFormat::Float32;          //requested
+    VertexFormat m_UploadedFormat = VertexFormat::Float32;  //what m_VBL describes
+    bool m_FromSections = false; //m_VBL is a stored set's position section, see UploadSections
+    BufferTexture m_FiberData; //Snorm16 and stored sections: center, half extent and color per fiber
 };
\ No newline at end of file
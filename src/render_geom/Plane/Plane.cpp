@@ -1,4 +1,5 @@
 #include "Plane.hpp"
+#include "../../GLStats.hpp"
 
 Plane::Plane(float width, float height)
     : m_width(width), m_height(height), m_VAO(), m_VBO(), m_IBO(), m_VBL()
@@ -15,8 +16,8 @@ Plane::Plane(float width, float height)
         2, 3, 0
     };
 
-    m_VBO = VertexBuffer(&m_Vertices[0], m_Vertices.size() * sizeof(float));
-    m_IBO = IndexBuffer(&m_Indices[0], m_Indices.size());
+    m_VBO = VertexBuffer(&m_Vertices[0], m_Vertices.size() * sizeof(float), BufferArena::Get());
+    m_IBO = IndexBuffer(&m_Indices[0], m_Indices.size(), BufferArena::Get());
     m_VBL.Push<float>(3);
     m_VAO.AddBuffer(m_VBO, m_VBL, false);
 }
@@ -25,5 +26,6 @@ void Plane::Draw() const
 {
     m_VAO.Bind();
     m_IBO.Bind();
-    glDrawElements(GL_TRIANGLES, m_IBO.GetCount(), GL_UNSIGNED_INT, nullptr);
+    glDrawElements(GL_TRIANGLES, m_IBO.GetCount(), GL_UNSIGNED_INT, m_IBO.GetIndices());
+    GLStats::CountDraw(m_IBO.GetCount());
 }
\ No newline at end of file
@@ -1,38 +1,87 @@
 #include "Points.hpp"
+#include "../../Profiler.hpp"
+#include "../../AllocationTracker.hpp"
+#include "../../GLStats.hpp"
+#include "../../Residency.hpp"
 
-Points::Points(std::vector<std::vector<double>> points, float pointSize = 1.0f)
-    : m_Points(points), m_VAO(), m_VBO(), m_VBL()
+// Compact vertex: position in four halves or shorts, then the color
+struct PointVertexPacked
 {
+    uint16_t position[4];
+    PackedUnorm1010102 color;
+};
+
+static const float previewRadius = 15.5f; //base points are scaled onto a sphere of this radius
+
+Points::Points(std::vector<std::vector<double>> points, float pointSize = 1.0f, VertexFormat format)
+    : m_Points(points), m_VAO(), m_VBO(), m_VBL(), m_Format(format)
+{
+    PROFILE_SCOPE("Points::Points");
     m_Colors.clear();
     for (int i = 0; i < m_Points.size(); i++)
     {
         m_Colors.push_back(GetColor(points[i]));
-        m_Points[i][0] *= 15.5f;
-        m_Points[i][1] *= 15.5f;
-        m_Points[i][2] *= 15.5f;
+        m_Points[i][0] *= previewRadius;
+        m_Points[i][1] *= previewRadius;
+        m_Points[i][2] *= previewRadius;
     }
     
     m_pointSize = pointSize;
     GenerateVertices();
-    m_VBO = VertexBuffer(&m_Vertices[0], m_Vertices.size() * sizeof(float));
-    m_VBL.Push<float>(3);
-    m_VBL.Push<float>(3);
-    m_VAO.AddBuffer(m_VBO, m_VBL, false);
+    switch (m_Format)
+    {
+    case VertexFormat::Float32:
+        m_VBL.Push<float>(3);
+        m_VBL.Push<float>(3);
+        break;
+    case VertexFormat::Half:
+        m_VBL.Push<HalfFloat>(4);
+        m_VBL.Push<PackedUnorm1010102>(4);
+        break;
+    case VertexFormat::Snorm16:
+        m_VBL.Push<short>(4);
+        m_VBL.Push<PackedUnorm1010102>(4);
+        break;
+    }
+    m_VBO = StreamBuffer((unsigned int)(m_Points.size() * m_VBL.GetStride()));
+    Upload();
 }
 
 void Points::UpdatePoints(std::vector<std::vector<double>>* points)
 {
+    PROFILE_FUNCTION();
+    ALLOC_SCOPE("Points::UpdatePoints");
     m_Colors.clear();
     m_Points = *points;
     for (int i = 0; i < m_Points.size(); i++)
     {
         m_Colors.push_back(GetColor((*points)[i]));
-        m_Points[i][0] *= 15.5f;
-        m_Points[i][1] *= 15.5f;
-        m_Points[i][2] *= 15.5f;
+        m_Points[i][0] *= previewRadius;
+        m_Points[i][1] *= previewRadius;
+        m_Points[i][2] *= previewRadius;
     }
     GenerateVertices();
-    m_VBO.UpdateData(&m_Vertices[0], m_Vertices.size() * sizeof(float));
+    Upload();
+}
+
+void Points::Upload()
+{
+    const void* data = m_Vertices.data();
+    unsigned int size = (unsigned int)(m_Vertices.size() * sizeof(float));
+    if (m_Format != VertexFormat::Float32)
+    {
+        data = m_Packed.data();
+        size = (unsigned int)m_Packed.size();
+    }
+    m_VAO.AddBuffer(m_VBO, m_VBO.Write(data, size), m_VBL, false); //each write lands in a new region
+    m_NumPoints = (unsigned int)m_Points.size();
+    if (Residency::IsGpuResident())
+    {
+        ReleaseStorage(m_Vertices);
+        ReleaseStorage(m_Packed);
+        ReleaseStorage(m_Points);
+        ReleaseStorage(m_Colors);
+    }
 }
 
 void Points::GenerateVertices()
@@ -47,11 +96,36 @@ void Points::GenerateVertices()
         m_Vertices.push_back((float)m_Colors[i][1]);
         m_Vertices.push_back((float)m_Colors[i][2]);
     }
+    if (m_Format == VertexFormat::Float32)
+        return;
+
+    m_Packed.resize(m_Points.size() * sizeof(PointVertexPacked));
+    PointVertexPacked* out = (PointVertexPacked*)m_Packed.data();
+    for (size_t i = 0; i < m_Points.size(); i++)
+    {
+        const float* in = &m_Vertices[i * 6];
+        if (m_Format == VertexFormat::Half)
+        {
+            for (int axis = 0; axis < 3; axis++)
+                out[i].position[axis] = FloatToHalf(in[axis]);
+            out[i].position[3] = FloatToHalf(1.0f);
+        }
+        else
+        {
+            // The points lie on the preview sphere, so the sphere is their bounds. w holds 1 / radius,
+            // and the perspective divide scales them back up without a uniform.
+            for (int axis = 0; axis < 3; axis++)
+                out[i].position[axis] = (uint16_t)QuantizeSnorm16(in[axis], -previewRadius, previewRadius);
+            out[i].position[3] = (uint16_t)QuantizeSnorm16(1.0f / previewRadius, -1.0f, 1.0f);
+        }
+        out[i].color.bits = PackUnorm1010102(in[3], in[4], in[5], 1.0f);
+    }
 }
 
 void Points::Draw()
 {
     m_VAO.Bind();
     glPointSize(m_pointSize);
-    glDrawArrays(GL_POINTS, 0, m_Points.size());
+    glDrawArrays(GL_POINTS, 0, m_NumPoints);
+    GLStats::CountDraw(m_NumPoints);
 }
\ No newline at end of file
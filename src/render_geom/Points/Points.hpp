@@ -6,28 +6,40 @@
 #include "../../VertexBuffer.hpp"
 #include "../../VertexArray.hpp"
 #include "../../VertexBufferLayout.hpp"
+#include "../../StreamBuffer.hpp"
 #include "../../IndexBuffer.hpp"
 #include "../../Shader.hpp"
 #include "../../GlobalFunctions.hpp"
+#include "../../VertexFormat.hpp"
 
 #include <vector>
 
 class Points
 {
 public:
-	Points(std::vector<std::vector<double>> points, float pointSize);
+	// Float32 vertices are 24 bytes; Half and Snorm16 are 12, with the color packed as 10_10_10_2
+	Points(std::vector<std::vector<double>> points, float pointSize, VertexFormat format = VertexFormat::Float32);
 	Points(){};
 	~Points() {};
+	Points(Points&&) noexcept = default; //owns its GL buffers, so moves only
+	Points& operator=(Points&&) noexcept = default;
+	Points(const Points&) = delete;
+	Points& operator=(const Points&) = delete;
 	void Draw();
 	void GenerateVertices();
 	void UpdatePoints(std::vector<std::vector<double>>* points);
 
 private:
+	void Upload();
+
 	VertexArray m_VAO;
-	VertexBuffer m_VBO;
+	StreamBuffer m_VBO; //rewritten on every edit of the base points
 	VertexBufferLayout m_VBL;
 	std::vector<float> m_Vertices;
+	std::vector<unsigned char> m_Packed; //m_Vertices in m_Format, when that is not Float32
     std::vector<std::vector<double>> m_Points;
     std::vector<std::vector<double>> m_Colors;
+    unsigned int m_NumPoints = 0; //drawn count; the vectors above are empty after upload in GPU-resident mode
 	float m_pointSize = 1.0f;
+	VertexFormat m_Format = VertexFormat::Float32;
 };
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "Sphere.hpp"
+#include "../../GLStats.hpp"
+#include "../../Residency.hpp"
 #include <iostream>
 
 Sphere::Sphere(float radius, int numPoints)
@@ -6,11 +8,12 @@ Sphere::Sphere(float radius, int numPoints)
 {
 	GenerateSphereVertices();
 	GenerateSphereIndices();
-	m_IBO = IndexBuffer(&m_Indices[0], m_Indices.size());
-	m_VBO = VertexBuffer(&m_Vertices[0], m_Vertices.size() * sizeof(float));
+	m_IBO = IndexBuffer(&m_Indices[0], m_Indices.size(), BufferArena::Get());
+	m_VBO = VertexBuffer(&m_Vertices[0], m_Vertices.size() * sizeof(float), BufferArena::Get());
 	
 	m_VBL.Push<float>(3);
 	m_VAO.AddBuffer(m_VBO, m_VBL, false);
+	ReleaseCpuCopies();
 }
 
 Sphere::Sphere(const std::vector<SphereInstance>& instances)
@@ -18,24 +21,25 @@ Sphere::Sphere(const std::vector<SphereInstance>& instances)
 {
 	GenerateSphereVertices();
 	GenerateSphereIndices();
-	m_IBO = IndexBuffer(&m_Indices[0], m_Indices.size());
-	m_VBO = VertexBuffer(&m_Vertices[0], m_Vertices.size() * sizeof(float));
+	m_IBO = IndexBuffer(&m_Indices[0], m_Indices.size(), BufferArena::Get());
+	m_VBO = VertexBuffer(&m_Vertices[0], m_Vertices.size() * sizeof(float), BufferArena::Get());
 	
 	m_VBL.Push<float>(3);
 	m_VAO.Bind();
 	m_VAO.AddBuffer(m_VBO, m_VBL, false);
 	
-	m_InstanceVBO = VertexBuffer(&instances[0], instances.size() * sizeof(SphereInstance));
+	m_InstanceVBO = VertexBuffer(&instances[0], instances.size() * sizeof(SphereInstance), BufferArena::Get());
 	m_InstanceVBO.Bind();
 
 	GLsizei stride = sizeof(SphereInstance);
+	size_t base = m_InstanceVBO.GetOffset(); //start of the instances in the arena block
 
 	GLCall(glEnableVertexAttribArray(1));
-	GLCall(glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(SphereInstance, position)));
+	GLCall(glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (const void*)(base + offsetof(SphereInstance, position))));
 	GLCall(glEnableVertexAttribArray(2));
-	GLCall(glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(SphereInstance, color)));
+	GLCall(glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (const void*)(base + offsetof(SphereInstance, color))));
 	GLCall(glEnableVertexAttribArray(3));
-	GLCall(glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(SphereInstance, radius)));
+	GLCall(glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (const void*)(base + offsetof(SphereInstance, radius))));
 	glVertexAttribDivisor(1, 1);
 	glVertexAttribDivisor(2, 1);
 	glVertexAttribDivisor(3, 1);
@@ -44,6 +48,16 @@ Sphere::Sphere(const std::vector<SphereInstance>& instances)
 
 	m_VAO.Unbind();
 	m_InstanceVBO.Unbind();
+	ReleaseCpuCopies();
+}
+
+void Sphere::ReleaseCpuCopies()
+{
+	if (Residency::IsGpuResident())
+	{
+		ReleaseStorage(m_Vertices);
+		ReleaseStorage(m_Indices);
+	}
 }
 
 void Sphere::GenerateSphereVertices()
@@ -100,11 +114,13 @@ void Sphere::Draw()
 	m_IBO.Bind();
 	if (m_Instanced)
 	{
-		glDrawElementsInstanced(GL_TRIANGLE_STRIP, m_Indices.size(), GL_UNSIGNED_INT, 0, m_numInstances);
+		glDrawElementsInstanced(GL_TRIANGLE_STRIP, m_IBO.GetCount(), GL_UNSIGNED_INT, m_IBO.GetIndices(), m_numInstances);
+		GLStats::CountDraw((unsigned long long)m_IBO.GetCount() * m_numInstances);
 	}
 	else
 	{
-		glDrawElements(GL_TRIANGLE_STRIP, m_Indices.size(), GL_UNSIGNED_INT, 0);
+		glDrawElements(GL_TRIANGLE_STRIP, m_IBO.GetCount(), GL_UNSIGNED_INT, m_IBO.GetIndices());
+		GLStats::CountDraw(m_IBO.GetCount());
 	}
 }
 
@@ -31,6 +31,10 @@ public:
 	Sphere(float radius, int numPoints);
 	Sphere(const std::vector<SphereInstance>& instances);
 	~Sphere() {};
+	Sphere(Sphere&&) noexcept = default; //owns its GL buffers, so moves only
+	Sphere& operator=(Sphere&&) noexcept = default;
+	Sphere(const Sphere&) = delete;
+	Sphere& operator=(const Sphere&) = delete;
 
 	void Draw();
 private:
@@ -38,6 +42,7 @@ private:
 	float m_Radius;
 	void GenerateSphereVertices();
 	void GenerateSphereIndices();
+	void ReleaseCpuCopies(); //only in GPU-resident mode
 	IndexBuffer m_IBO;
 	VertexArray m_VAO;
 	VertexBuffer m_VBO;